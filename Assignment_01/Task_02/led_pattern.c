@@ -0,0 +1,112 @@
+/*
+ * LED pattern engine, see led_pattern.h.
+ */
+
+/* Scheduler includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "led_pattern.h"
+#include "tick_heap.h"
+
+// Global Variables
+static const LedPattern_st *pxLedPatterns = NULL;
+static UBaseType_t uxLedCount = 0;
+static uint8_t ucLedSteps[ LED_PATTERN_MAX_OUTPUTS ]; // Index of the next bit to play
+static TickType_t xLedNextSteps[ LED_PATTERN_MAX_OUTPUTS ]; // Tick of the next step
+static uint8_t ucLedSlots[ LED_PATTERN_MAX_OUTPUTS ];
+static TickHeap_st xLedHeap; // Outputs by next step
+
+// Prototypes
+static void prvLedPatternTask( void *pvParameters );
+static TickType_t prvLedPlayStep( UBaseType_t uxOutput );
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Drives the pin for the next bit and returns how long it lasts.
+ */
+static TickType_t prvLedPlayStep( UBaseType_t uxOutput )
+{
+	const LedPattern_st *pxPattern = &pxLedPatterns[ uxOutput ];
+	TickType_t xDuration;
+
+	if( ( pxPattern->ulPattern & ( 1UL << ucLedSteps[ uxOutput ] ) ) != 0 )
+	{
+		GPIO_write( pxPattern->xPort, pxPattern->xPin, PIN_IS_HIGH );
+		xDuration = pxPattern->xOnTime;
+	}
+	else
+	{
+		GPIO_write( pxPattern->xPort, pxPattern->xPin, PIN_IS_LOW );
+		xDuration = pxPattern->xOffTime;
+	}
+
+	ucLedSteps[ uxOutput ]++;
+
+	if( ucLedSteps[ uxOutput ] >= pxPattern->ucPatternLength )
+	{
+		ucLedSteps[ uxOutput ] = 0;
+	}
+
+	return xDuration;
+}
+/*-----------------------------------------------------------*/
+
+static void prvLedPatternTask( void *pvParameters )
+{
+	UBaseType_t uxIndex;
+	uint8_t ucOutput;
+	TickType_t xNow = xTaskGetTickCount(), xWakeTime;
+
+	( void ) pvParameters;
+
+	// First step of every output now
+	for( uxIndex = 0; uxIndex < uxLedCount; uxIndex++ )
+	{
+		ucLedSteps[ uxIndex ] = 0;
+		xLedNextSteps[ uxIndex ] = xNow;
+	}
+
+	vTickHeapInit( &xLedHeap, ucLedSlots, xLedNextSteps, uxLedCount );
+
+	xWakeTime = xNow;
+
+	for( ;; )
+	{
+		// Play every step that is due, each one moves its output down the heap
+		while( !TICK_BEFORE( xWakeTime, xTickHeapRootKey( &xLedHeap ) ) )
+		{
+			ucOutput = ucTickHeapRoot( &xLedHeap );
+
+			// From the scheduled tick, so late wakeups do not add up
+			xLedNextSteps[ ucOutput ] += prvLedPlayStep( ucOutput );
+			vTickHeapSiftDown( &xLedHeap, 0 );
+		}
+
+		// Sleep until the earliest next step
+		vTaskDelayUntil( &xWakeTime, xTickHeapRootKey( &xLedHeap ) - xWakeTime );
+	}
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xLedPatternStart( const LedPattern_st * pxPatterns,
+                             UBaseType_t uxCount,
+                             UBaseType_t uxPriority )
+{
+	UBaseType_t uxIndex;
+
+	configASSERT( ( uxCount > 0 ) && ( uxCount <= LED_PATTERN_MAX_OUTPUTS ) );
+
+	for( uxIndex = 0; uxIndex < uxCount; uxIndex++ )
+	{
+		// A step of 0 ticks would keep the task spinning on that output
+		configASSERT( ( pxPatterns[ uxIndex ].ucPatternLength > 0 ) && ( pxPatterns[ uxIndex ].ucPatternLength <= 32 ) );
+		configASSERT( ( pxPatterns[ uxIndex ].xOnTime > 0 ) && ( pxPatterns[ uxIndex ].xOffTime > 0 ) );
+	}
+
+	pxLedPatterns = pxPatterns;
+	uxLedCount = uxCount;
+
+	return xTaskCreate( prvLedPatternTask, "LEDs", configMINIMAL_STACK_SIZE, NULL, uxPriority, NULL );
+}
@@ -0,0 +1,47 @@
+/*
+ * LED pattern engine.
+ *
+ * One task drives every output of a pattern table.  Each output plays its
+ * bit string over and over, LSB first: a 1 bit drives the pin high for the
+ * on-time, a 0 bit drives it low for the off-time.  The outputs are kept in
+ * a heap ordered by their next step, the task sleeps until the earliest one
+ * and reschedules only the outputs that are due, so adding an output costs a
+ * table entry, not a task.
+ */
+
+#ifndef LED_PATTERN_H
+#define LED_PATTERN_H
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "GPIO.h"
+
+// Max number of outputs driven by the engine
+#ifndef LED_PATTERN_MAX_OUTPUTS
+#define LED_PATTERN_MAX_OUTPUTS 16
+#endif
+
+// Type definitions
+typedef struct
+{
+	portX_t xPort;
+	pinX_t xPin;
+	TickType_t xOnTime; // Duration of a 1 bit
+	TickType_t xOffTime; // Duration of a 0 bit
+	uint32_t ulPattern; // Steps, LSB first
+	uint8_t ucPatternLength; // Number of steps in ulPattern, 1 to 32
+} LedPattern_st;
+
+// Plain blinking: on for xPeriod, then off for xPeriod
+#define LED_PATTERN_BLINK(xPort, xPin, xPeriod) { (xPort), (xPin), (xPeriod), (xPeriod), 0x1UL, 2 }
+
+/*
+ * Creates the engine task at uxPriority, playing uxCount patterns from
+ * pxPatterns (used in place, keep the table alive).  Returns pdPASS or
+ * pdFAIL.
+ */
+BaseType_t xLedPatternStart( const LedPattern_st * pxPatterns,
+                             UBaseType_t uxCount,
+                             UBaseType_t uxPriority );
+
+#endif /* LED_PATTERN_H */
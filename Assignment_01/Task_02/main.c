@@ -65,6 +65,9 @@
 #include "serial.h"
 #include "GPIO.h"
 
+// More Application includes
+#include "led_pattern.h"
+
 
 /*-----------------------------------------------------------*/
 
@@ -74,16 +77,14 @@
 /* Constants for the ComTest demo application tasks. */
 #define mainCOM_TEST_BAUD_RATE	( ( unsigned long ) 115200 )
 
-// Type definitions
-typedef struct
-{
-	pinX_t pin_num;
-	int toggle_rate;
-} LED_data_st;
-
-
 // Global Variables
-TaskHandle_t LED_handle1 = NULL, LED_handle2 = NULL, LED_handle3 = NULL;
+// LEDs blinking at 100, 500 and 1000 ms, all driven by the pattern engine task
+const LedPattern_st LED_patterns[] =
+{
+	LED_PATTERN_BLINK(PORT_0, PIN1, 100),
+	LED_PATTERN_BLINK(PORT_0, PIN2, 500),
+	LED_PATTERN_BLINK(PORT_0, PIN3, 1000)
+};
 
 /*
  * Configure the processor for use with the Keil demo board.  This is very
@@ -94,50 +95,20 @@ static void prvSetupHardware( void );
 /*-----------------------------------------------------------*/
 
 
-// Prototypes for task codes
-void LED_task_code(void*);
-
-
 /*
  * Application entry point:
  * Starts all the other tasks, then starts the scheduler. 
  */
 int main( void )
 {
-	// Local Variables
-	LED_data_st LED1_data = {PIN1, 100};
-	LED_data_st LED2_data = {PIN2, 500};
-	LED_data_st LED3_data = {PIN3, 1000};
-
 	/* Setup the hardware for use with the Keil demo board. */
 	prvSetupHardware();
 
 	
   /* Create Tasks here */
 	
-	// Task 1
-	xTaskCreate(LED_task_code, // Function that implements the task.
-              "LED Task1", // Text name for the task.
-              50, // Stack size in words, not bytes.
-              (void*)&LED1_data, // Parameter passed into the task.
-              1, // Priority at which the task is created.
-              &LED_handle1 ); // Used to pass out the created task's handle.
-	
-	// Task 2							
-	xTaskCreate(LED_task_code, // Function that implements the task.
-              "LED Task2", // Text name for the task.
-              50, // Stack size in words, not bytes.
-              (void*)&LED2_data, // Parameter passed into the task.
-              1, // Priority at which the task is created.
-              &LED_handle2 ); // Used to pass out the created task's handle.
-	
-	// Task 3
-	xTaskCreate(LED_task_code, // Function that implements the task.
-              "LED Task3", // Text name for the task.
-              50, // Stack size in words, not bytes.
-              (void*)&LED3_data, // Parameter passed into the task.
-              1, // Priority at which the task is created.
-              &LED_handle3 ); // Used to pass out the created task's handle.
+	// LED pattern engine, one task for all the LEDs
+	xLedPatternStart(LED_patterns, sizeof(LED_patterns) / sizeof(LED_patterns[0]), 1);
 
 
 	/* Now all the tasks have been started - start the scheduler.
@@ -170,22 +141,3 @@ static void prvSetupHardware( void )
 	VPBDIV = mainBUS_CLK_FULL;
 }
 /*-----------------------------------------------------------*/
-
-void LED_task_code(void* data)
-{
-	while(1)
-	{
-		// Access Pin number and make it high
-		GPIO_write(PORT_0, ((LED_data_st *)data)->pin_num, PIN_IS_HIGH);
-		
-		// Access delay period
-		vTaskDelay(((LED_data_st *)data)->toggle_rate);
-		
-		// Access Pin number and make it low
-		GPIO_write(PORT_0, ((LED_data_st *)data)->pin_num, PIN_IS_LOW);
-		
-		// Access delay period
-		vTaskDelay(((LED_data_st *)data)->toggle_rate);
-	}
-}
-
@@ -0,0 +1,225 @@
+/*
+ * Press-gesture recognizer, see gesture.h.
+ */
+
+/* Scheduler includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+
+#include "gesture.h"
+
+// Type definitions
+typedef struct
+{
+	BaseType_t xPressed;
+	TickType_t xPressTime;
+	uint8_t ucClicks; // Clicks waiting for the multi-click window to close
+	TickType_t xClickDuration;
+	TickType_t xClickTime;
+} GestureState_st;
+
+// Global Variables
+static const GestureButton_st *pxGestureButtons = NULL;
+static UBaseType_t uxGestureButtonCount = 0;
+static GestureState_st xGestureStates[ GESTURE_MAX_BUTTONS ];
+static QueueHandle_t xGestureEdges = NULL;
+static QueueHandle_t xGestureEvents = NULL;
+
+// Prototypes
+static void prvGestureTask( void *pvParameters );
+static Gesture_t prvGestureClassify( const GestureButton_st *pxButton, TickType_t xDuration );
+static void prvGestureSend( UBaseType_t uxButton, Gesture_t xGesture, uint8_t ucClicks, TickType_t xDuration, TickType_t xTimeStamp );
+static void prvGestureFlushClicks( UBaseType_t uxButton );
+static void prvGestureEdge( const InputEvent_st *pxEdge );
+static TickType_t prvGestureExpire( TickType_t xNow );
+
+/*-----------------------------------------------------------*/
+
+static Gesture_t prvGestureClassify( const GestureButton_st *pxButton, TickType_t xDuration )
+{
+	UBaseType_t uxIndex = pxButton->uxClassCount;
+
+	// Longest class the press reaches
+	while( ( uxIndex > 1 ) && ( xDuration < pxButton->pxClasses[ uxIndex - 1 ].xMinDuration ) )
+	{
+		uxIndex--;
+	}
+
+	return pxButton->pxClasses[ uxIndex - 1 ].xGesture;
+}
+/*-----------------------------------------------------------*/
+
+static void prvGestureSend( UBaseType_t uxButton, Gesture_t xGesture, uint8_t ucClicks, TickType_t xDuration, TickType_t xTimeStamp )
+{
+	GestureEvent_st xEvent;
+
+	xEvent.ucButton = ( uint8_t ) uxButton;
+	xEvent.xGesture = xGesture;
+	xEvent.ucClicks = ucClicks;
+	xEvent.xDuration = xDuration;
+	xEvent.xTimeStamp = xTimeStamp;
+
+	// A consumer that lags behind loses gestures, it never stalls the recognizer
+	( void ) xQueueSend( xGestureEvents, &xEvent, 0 );
+}
+/*-----------------------------------------------------------*/
+
+static void prvGestureFlushClicks( UBaseType_t uxButton )
+{
+	GestureState_st *pxState = &xGestureStates[ uxButton ];
+
+	if( pxState->ucClicks > 0 )
+	{
+		prvGestureSend( uxButton, GESTURE_CLICK, pxState->ucClicks, pxState->xClickDuration, pxState->xClickTime );
+		pxState->ucClicks = 0;
+	}
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * Handles one debounced edge, the input ID of the edge is the button index.
+ */
+static void prvGestureEdge( const InputEvent_st *pxEdge )
+{
+	const GestureButton_st *pxButton = &pxGestureButtons[ pxEdge->ucInputId ];
+	GestureState_st *pxState = &xGestureStates[ pxEdge->ucInputId ];
+	TickType_t xDuration;
+	Gesture_t xGesture;
+
+	if( pxEdge->xState == pxButton->xPressedState )
+	{
+		// Pressed after the window closed: the earlier clicks stand alone
+		if( ( pxState->ucClicks > 0 ) && ( ( TickType_t ) ( pxEdge->xTimeStamp - pxState->xClickTime ) > pxButton->xMultiClickWindow ) )
+		{
+			prvGestureFlushClicks( pxEdge->ucInputId );
+		}
+
+		pxState->xPressed = pdTRUE;
+		pxState->xPressTime = pxEdge->xTimeStamp;
+		return;
+	}
+
+	// Released without a press seen (button held at start-up)
+	if( pxState->xPressed == pdFALSE )
+	{
+		return;
+	}
+
+	pxState->xPressed = pdFALSE;
+	xDuration = pxEdge->xTimeStamp - pxState->xPressTime;
+	xGesture = prvGestureClassify( pxButton, xDuration );
+
+	if( ( xGesture == GESTURE_CLICK ) && ( pxButton->xMultiClickWindow > 0 ) )
+	{
+		// Wait for the window to close, another click may follow
+		pxState->ucClicks++;
+		pxState->xClickDuration = xDuration;
+		pxState->xClickTime = pxEdge->xTimeStamp;
+
+		if( pxState->ucClicks == UINT8_MAX )
+		{
+			prvGestureFlushClicks( pxEdge->ucInputId );
+		}
+	}
+	else
+	{
+		prvGestureFlushClicks( pxEdge->ucInputId );
+		prvGestureSend( pxEdge->ucInputId, xGesture, 1, xDuration, pxEdge->xTimeStamp );
+	}
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * Reports the clicks whose window has closed and returns how long the task
+ * may sleep before the next window closes.
+ */
+static TickType_t prvGestureExpire( TickType_t xNow )
+{
+	GestureState_st *pxState;
+	UBaseType_t uxButton;
+	TickType_t xElapsed, xWindow, xSleep = portMAX_DELAY;
+
+	for( uxButton = 0; uxButton < uxGestureButtonCount; uxButton++ )
+	{
+		pxState = &xGestureStates[ uxButton ];
+
+		// A press in progress decides on its release
+		if( ( pxState->ucClicks == 0 ) || ( pxState->xPressed != pdFALSE ) )
+		{
+			continue;
+		}
+
+		xElapsed = xNow - pxState->xClickTime;
+		xWindow = pxGestureButtons[ uxButton ].xMultiClickWindow;
+
+		if( xElapsed > xWindow )
+		{
+			prvGestureFlushClicks( uxButton );
+		}
+		else if( ( xWindow - xElapsed + 1 ) < xSleep )
+		{
+			xSleep = xWindow - xElapsed + 1;
+		}
+	}
+
+	return xSleep;
+}
+/*-----------------------------------------------------------*/
+
+static void prvGestureTask( void *pvParameters )
+{
+	InputEvent_st xEdge;
+	TickType_t xSleep = portMAX_DELAY;
+
+	( void ) pvParameters;
+
+	for( ;; )
+	{
+		// No CPU between edges, except to close a multi-click window
+		if( xQueueReceive( xGestureEdges, &xEdge, xSleep ) == pdTRUE )
+		{
+			prvGestureEdge( &xEdge );
+		}
+
+		xSleep = prvGestureExpire( xTaskGetTickCount() );
+	}
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xGestureInit( const GestureButton_st * pxButtons,
+                         UBaseType_t uxButtonCount,
+                         QueueHandle_t xEvents,
+                         UBaseType_t uxPriority )
+{
+	UBaseType_t uxButton;
+
+	configASSERT( ( uxButtonCount > 0 ) && ( uxButtonCount <= GESTURE_MAX_BUTTONS ) && ( xEvents != NULL ) );
+
+	xGestureEdges = xQueueCreate( GESTURE_EDGE_QUEUE_LEN, sizeof( InputEvent_st ) );
+
+	if( xGestureEdges == NULL )
+	{
+		return pdFAIL;
+	}
+
+	xGestureEvents = xEvents;
+	pxGestureButtons = pxButtons;
+	uxGestureButtonCount = uxButtonCount;
+
+	for( uxButton = 0; uxButton < uxButtonCount; uxButton++ )
+	{
+		configASSERT( ( pxButtons[ uxButton ].uxClassCount > 0 ) && ( pxButtons[ uxButton ].pxClasses[ 0 ].xMinDuration == 0 ) );
+
+		xGestureStates[ uxButton ].xPressed = pdFALSE;
+		xGestureStates[ uxButton ].ucClicks = 0;
+
+		// Edges tagged with the button index, queued until the task runs
+		if( xInputServiceSubscribe( pxButtons[ uxButton ].xPort, pxButtons[ uxButton ].xPin, ( uint8_t ) uxButton, xGestureEdges ) != pdPASS )
+		{
+			return pdFAIL;
+		}
+	}
+
+	return xTaskCreate( prvGestureTask, "Gesture", configMINIMAL_STACK_SIZE, NULL, uxPriority, NULL );
+}
@@ -0,0 +1,81 @@
+/*
+ * Press-gesture recognizer.
+ *
+ * The buttons are sampled and debounced by the GPIO input service
+ * (common/input_service.h); only their time-stamped edges reach the gesture
+ * task, which sleeps until the next edge or the end of a multi-click window.  A press is classified by its
+ * duration with the button's class table (the longest class whose minimum
+ * duration it reaches), and short presses of the GESTURE_CLICK class that
+ * follow each other within the multi-click window are counted into a single
+ * event.  Events go to the queue given to xGestureInit().
+ *
+ * Requires configUSE_TICK_HOOK set to 1, with vInputServiceScanFromISR()
+ * called from vApplicationTickHook().
+ */
+
+#ifndef GESTURE_H
+#define GESTURE_H
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "GPIO.h"
+
+#include "input_service.h"
+
+// Number of buttons the recognizer can watch
+#ifndef GESTURE_MAX_BUTTONS
+#define GESTURE_MAX_BUTTONS 4
+#endif
+
+// Edges waiting for the gesture task
+#ifndef GESTURE_EDGE_QUEUE_LEN
+#define GESTURE_EDGE_QUEUE_LEN 8
+#endif
+
+// Type definitions
+typedef enum
+{
+	GESTURE_CLICK, // Short press, counted with the ones that follow it
+	GESTURE_LONG_PRESS,
+	GESTURE_VERY_LONG_PRESS
+} Gesture_t;
+
+typedef struct
+{
+	TickType_t xMinDuration; // Shortest press of this class
+	Gesture_t xGesture;
+} GestureClass_st;
+
+typedef struct
+{
+	portX_t xPort;
+	pinX_t xPin;
+	pinState_t xPressedState;
+	const GestureClass_st *pxClasses; // Sorted by xMinDuration, the first one at 0
+	UBaseType_t uxClassCount;
+	TickType_t xMultiClickWindow; // Max gap between two clicks, 0 reports every click alone
+} GestureButton_st;
+
+typedef struct
+{
+	uint8_t ucButton; // Index in the table given to xGestureInit()
+	Gesture_t xGesture;
+	uint8_t ucClicks; // Number of clicks for GESTURE_CLICK, 1 otherwise
+	TickType_t xDuration; // Duration of the (last) press
+	TickType_t xTimeStamp; // Tick of the (last) release
+} GestureEvent_st;
+
+/*
+ * Subscribes to the edges of the uxButtonCount buttons described by
+ * pxButtons (the table is used in place, keep it alive) and creates the
+ * gesture task at uxPriority.  Events are sent to xEvents, a queue of
+ * GestureEvent_st.  Returns pdPASS, or pdFAIL if the heap or the tables of
+ * the input service are full.
+ */
+BaseType_t xGestureInit( const GestureButton_st * pxButtons,
+                         UBaseType_t uxButtonCount,
+                         QueueHandle_t xEvents,
+                         UBaseType_t uxPriority );
+
+#endif /* GESTURE_H */
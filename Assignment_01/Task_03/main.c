@@ -65,6 +65,10 @@
 #include "serial.h"
 #include "GPIO.h"
 
+// More Application includes
+#include "queue.h"
+#include "gesture.h"
+
 
 /*-----------------------------------------------------------*/
 
@@ -77,6 +81,13 @@
 // Constant for Toggling state
 #define NO_TOGGLE 0
 
+// Press durations in ms (ticks), a press shorter than LONG_PRESS is a click
+#define LONG_PRESS 2000
+#define VERY_LONG_PRESS 4000
+
+// Max number of gestures waiting for the button task
+#define GESTURE_QUEUE_LEN 4
+
 // Type definitions
 typedef struct
 {
@@ -88,6 +99,26 @@ typedef struct
 // Global Variables
 TaskHandle_t LED_handle = NULL, Button_handle = NULL;
 
+// New LED settings, only the LED task touches the LED
+QueueHandle_t LED_commands;
+
+// Gestures of the button
+QueueHandle_t gestures;
+
+// Press classes of the button, by increasing duration
+const GestureClass_st button_classes[] =
+{
+	{0, GESTURE_CLICK},
+	{LONG_PRESS, GESTURE_LONG_PRESS},
+	{VERY_LONG_PRESS, GESTURE_VERY_LONG_PRESS}
+};
+
+// Watched buttons
+const GestureButton_st buttons[] =
+{
+	{PORT_0, PIN0, PIN_IS_HIGH, button_classes, 3, 0} // Every click reported alone
+};
+
 
 /*
  * Configure the processor for use with the Keil demo board.  This is very
@@ -114,7 +145,16 @@ int main( void )
 	
 	/* Setup the hardware for use with the Keil demo board. */
 	prvSetupHardware();
-
+	
+	// Create Queues
+	LED_commands = xQueueCreate(1, sizeof(LED_data_st));
+	gestures = xQueueCreate(GESTURE_QUEUE_LEN, sizeof(GestureEvent_st));
+	
+	// Start recognizing gestures, the input service samples the button from the tick hook
+	if(xGestureInit(buttons, 1, gestures, 2) != pdPASS)
+	{
+		for(;;); // Out of heap or input service slots
+	}
 	
   /* Create Tasks here */
 	
@@ -130,7 +170,7 @@ int main( void )
 	xTaskCreate(Button_task_code, // Function that implements the task.
               "Button Task", // Text name for the task.
               50, // Stack size in words, not bytes.
-              (void*)&LED1, // Parameter passed into the task.
+              (void*)NULL, // Parameter passed into the task.
               1, // Priority at which the task is created.
               &Button_handle ); // Used to pass out the created task's handle.
 
@@ -168,25 +208,26 @@ static void prvSetupHardware( void )
 
 void LED_task_code(void *data)
 {
+	// LED settings, owned by this task
+	LED_data_st LED = *(LED_data_st *)data;
+	LED_data_st command;
+	
 	while(1)
 	{
 		// Write current pin state
-		GPIO_write(PORT_0, ((LED_data_st *)data)->pin_num, ((LED_data_st *)data)->pin_state);
+		GPIO_write(PORT_0, LED.pin_num, LED.pin_state);
 		
-		// Check if toggling is disabled
-		if(((LED_data_st *)data)->toggle_rate == NO_TOGGLE)
+		// Wait for new settings: forever if toggling is disabled, one toggle period otherwise
+		if(xQueueReceive(LED_commands, &command, (LED.toggle_rate == NO_TOGGLE) ? portMAX_DELAY : (TickType_t)LED.toggle_rate) == pdTRUE)
 		{
-			// Suspend this task as the pin state is low
-			vTaskSuspend(NULL);
-			//vTaskDelay(10);
+			// Apply the new settings
+			LED.pin_state = command.pin_state;
+			LED.toggle_rate = command.toggle_rate;
 		}
-		else // Toggling is enabled
+		else // Toggle period elapsed
 		{
 			// Toggle pin state
-			((LED_data_st *)data)->pin_state ^= 1;
-			
-			// Apply toggle rate
-			vTaskDelay(((LED_data_st *)data)->toggle_rate);
+			LED.pin_state ^= 1;
 		}
 	}
 }
@@ -194,61 +235,42 @@ void LED_task_code(void *data)
 
 void Button_task_code(void *data)
 {
-	// Initial State
-	unsigned long duration = 0;
-	pinState_t pin0_prev_state = GPIO_read(PORT_0, PIN0);
-	pinState_t pin0_curr_state = pin0_prev_state;
+	// Gesture reported by the recognizer
+	GestureEvent_st gesture;
+	
+	// LED settings to apply
+	LED_data_st command = {PIN1, PIN_IS_LOW, NO_TOGGLE};
 	
 	while(1)
 	{
-		// Read pin 0 state
-		pin0_curr_state = GPIO_read(PORT_0, PIN0);
+		// Sleep until the next gesture
+		xQueueReceive(gestures, &gesture, portMAX_DELAY);
 		
-		// Check pin 0 state
-		if(pin0_curr_state == PIN_IS_HIGH)
+		if(gesture.xGesture == GESTURE_CLICK)
 		{
-			// Continue measuring press duration
-			duration += 10;
+			// Disable toggling and switch the LED off
+			command.toggle_rate = NO_TOGGLE;
+			command.pin_state = PIN_IS_LOW;
 		}
-		else // PIN_IS_LOW
+		else if(gesture.xGesture == GESTURE_LONG_PRESS)
 		{
-			if(pin0_prev_state == PIN_IS_HIGH)
-			{
-				if(duration >= 0 && duration < 2000)
-				{
-					// Disable toggling
-					((LED_data_st *)data)->toggle_rate = NO_TOGGLE;
-				
-					// Clear pin (switch LED off)
-					((LED_data_st *)data)->pin_state = PIN_IS_LOW;
-				}
-				else if(duration >= 2000 && duration < 4000)
-				{
-					// Re-enable toggling with a rate
-					((LED_data_st *)data)->toggle_rate = 400;
-				
-					// Bring LED Task again to the schedular
-					vTaskResume(LED_handle);
-				}
-				else // >= 4000
-				{
-					// Re-enable toggling with a rate
-					((LED_data_st *)data)->toggle_rate = 100;
-				
-					// Bring LED Task again to the schedular
-					vTaskResume(LED_handle);
-				}
-			}
-			
-			// Reset press duration
-			duration = 0;
+			// Re-enable toggling with a rate
+			command.toggle_rate = 400;
+		}
+		else // GESTURE_VERY_LONG_PRESS
+		{
+			// Re-enable toggling with a rate
+			command.toggle_rate = 100;
 		}
 		
-		// Prepare for state transition (save last state)
-		pin0_prev_state = pin0_curr_state;
-		
-		// Check every 10 ms
-		vTaskDelay(10);
+		// Hand the new settings to the LED task, newer settings replace pending ones
+		xQueueOverwrite(LED_commands, &command);
 	}
 }
+/*-----------------------------------------------------------*/
 
+void vApplicationTickHook(void)
+{
+	// Button sampling and debouncing
+	vInputServiceScanFromISR();
+}
@@ -65,6 +65,10 @@
 #include "serial.h"
 #include "GPIO.h"
 
+// More Application includes
+#include "queue.h"
+#include "input_service.h"
+
 
 /*-----------------------------------------------------------*/
 
@@ -74,9 +78,15 @@
 /* Constants for the ComTest demo application tasks. */
 #define mainCOM_TEST_BAUD_RATE	( ( unsigned long ) 115200 )
 
+// Max number of button edges waiting for the button task
+#define BUTTON_EVENT_QUEUE_LEN 4
+
 // Global Variables
 TaskHandle_t LED_handle = NULL, Button_handle = NULL;
 
+// Debounced edges of the button
+QueueHandle_t button_events;
+
 
 /*
  * Configure the processor for use with the Keil demo board.  This is very
@@ -103,6 +113,10 @@ int main( void )
 	
 	/* Setup the hardware for use with the Keil demo board. */
 	prvSetupHardware();
+	
+	// Subscribe the button task to its pin, sampled from the tick hook
+	button_events = xQueueCreate(BUTTON_EVENT_QUEUE_LEN, sizeof(InputEvent_st));
+	xInputServiceSubscribe(PORT_0, PIN0, 0, button_events);
 
 	
   /* Create Tasks here */
@@ -170,34 +184,27 @@ void LED_task_code(void *state)
 
 void Button_task_code(void *state)
 {
-	// Initial State
-	pinState_t Button_prev_state = GPIO_read(PORT_0, PIN0);
-	pinState_t Button_curr_state;
+	// Debounced edge
+	InputEvent_st button_event;
 	
 	while(1)
 	{
-		// Read pin 0 state
-		Button_curr_state = GPIO_read(PORT_0, PIN0);
+		// Sleep until the input service reports an edge
+		xQueueReceive(button_events, &button_event, portMAX_DELAY);
 		
-		// Check pin 0 state
-		if(Button_curr_state != Button_prev_state)
+		// Check valid state transition from high to low
+		if(button_event.xState == PIN_IS_LOW)
 		{
-			// Check valid state transition from high to low
-			if(Button_curr_state == PIN_IS_LOW) // prev = HIGH
-			{
-				(*(pinState_t *)state) ^= 1;
-			}
-			
-			// else: Don't Care
+			(*(pinState_t *)state) ^= 1;
 		}
 		
 		// else: Don't Care
-		
-		// Prepare for state transition (save last state)
-		Button_prev_state = Button_curr_state;
-		
-		// Check every 10 ms
-		vTaskDelay(10);
 	}
 }
+/*-----------------------------------------------------------*/
 
+void vApplicationTickHook(void)
+{
+	// Button sampling and debouncing
+	vInputServiceScanFromISR();
+}
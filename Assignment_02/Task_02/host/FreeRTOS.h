@@ -0,0 +1,26 @@
+/*
+ * Host stand-in for the FreeRTOS.h of the kernel, with just what
+ * ../uart_tx.c uses, so uart_tx_sim.c can build the driver unchanged.  The
+ * types have the sizes of the ARM7 port.
+ */
+
+#ifndef FREERTOS_H_HOST
+#define FREERTOS_H_HOST
+
+/* Standard includes. */
+#include <stddef.h>
+#include <stdint.h>
+#include <assert.h>
+
+typedef long BaseType_t;
+typedef unsigned long UBaseType_t;
+typedef uint32_t TickType_t;
+
+#define pdFALSE ( ( BaseType_t ) 0 )
+#define pdTRUE ( ( BaseType_t ) 1 )
+#define pdPASS ( pdTRUE )
+#define pdFAIL ( pdFALSE )
+
+#define configASSERT( x ) assert( x )
+
+#endif /* FREERTOS_H_HOST */
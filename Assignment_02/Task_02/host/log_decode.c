@@ -0,0 +1,137 @@
+/*
+ * Host decoder of the deferred binary log (see ../log.h).
+ *
+ * Reads the raw UART byte stream from a file or stdin and prints every record
+ * as text, prefixed with its tick count:
+ *
+ *     gcc -o log_decode log_decode.c
+ *     ./log_decode capture.bin
+ *
+ * The 16-bit tick stamps are extended to 32 bits across their wraps, which
+ * holds as long as two consecutive records are less than 65 s apart.
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+#include <stdint.h>
+
+#include "../log_formats.h"
+
+// Type definitions
+typedef struct
+{
+	unsigned int uiArgCount;
+	const char *pcFormat;
+} LogFormat_st;
+
+#define LOG_FORMAT_ENTRY(ID, ARGC, FORMAT) { ARGC, FORMAT },
+
+// Global Variables
+static const LogFormat_st xLogFormats[ LOG_ID_COUNT ] = { LOG_FORMAT_TABLE(LOG_FORMAT_ENTRY) };
+
+/*-----------------------------------------------------------*/
+
+static int prvReadBytes( FILE *pxInput, uint8_t *pucBuffer, unsigned int uiCount )
+{
+	return fread( pucBuffer, 1, uiCount, pxInput ) == uiCount;
+}
+/*-----------------------------------------------------------*/
+
+static int prvReadVarint( FILE *pxInput, unsigned long *pulValue )
+{
+	unsigned int uiShift;
+	int iByte;
+
+	*pulValue = 0;
+
+	for( uiShift = 0; uiShift < ( 7 * LOG_ARG_MAX_LEN ); uiShift += 7 )
+	{
+		iByte = fgetc( pxInput );
+
+		if( iByte == EOF )
+		{
+			return 0;
+		}
+
+		*pulValue |= ( unsigned long ) ( iByte & 0x7F ) << uiShift;
+
+		if( ( iByte & 0x80 ) == 0 )
+		{
+			*pulValue &= 0xFFFFFFFFUL;
+			return 1;
+		}
+	}
+
+	return 0;
+}
+/*-----------------------------------------------------------*/
+
+int main( int argc, char *argv[] )
+{
+	FILE *pxInput = stdin;
+	uint8_t ucHeader[ LOG_HEADER_LEN - 1 ];
+	unsigned long ulArgs[ LOG_MAX_ARGS ];
+	unsigned long ulTime = 0, ulSkipped = 0;
+	uint16_t usLastStamp = 0, usStamp;
+	unsigned int uiIndex;
+	int iByte;
+
+	if( argc > 1 )
+	{
+		pxInput = fopen( argv[ 1 ], "rb" );
+
+		if( pxInput == NULL )
+		{
+			perror( argv[ 1 ] );
+			return 1;
+		}
+	}
+
+	while( ( iByte = fgetc( pxInput ) ) != EOF )
+	{
+		// Out of step, look for the next record
+		if( iByte != LOG_SYNC_BYTE )
+		{
+			ulSkipped++;
+			continue;
+		}
+
+		if( !prvReadBytes( pxInput, ucHeader, sizeof( ucHeader ) ) )
+		{
+			break;
+		}
+
+		if( ucHeader[ 0 ] >= LOG_ID_COUNT )
+		{
+			ulSkipped++;
+			continue;
+		}
+
+		for( uiIndex = 0; uiIndex < xLogFormats[ ucHeader[ 0 ] ].uiArgCount; uiIndex++ )
+		{
+			if( !prvReadVarint( pxInput, &ulArgs[ uiIndex ] ) )
+			{
+				break;
+			}
+		}
+
+		if( uiIndex < xLogFormats[ ucHeader[ 0 ] ].uiArgCount )
+		{
+			break;
+		}
+
+		usStamp = ( uint16_t ) ( ucHeader[ 1 ] | ( ucHeader[ 2 ] << 8 ) );
+		ulTime += ( uint16_t ) ( usStamp - usLastStamp );
+		usLastStamp = usStamp;
+
+		printf( "[%8lu] ", ulTime );
+		printf( xLogFormats[ ucHeader[ 0 ] ].pcFormat, ulArgs[ 0 ], ulArgs[ 1 ], ulArgs[ 2 ], ulArgs[ 3 ] );
+	}
+
+	if( ulSkipped != 0 )
+	{
+		fprintf( stderr, "%lu bytes skipped while looking for records\n", ulSkipped );
+	}
+
+	return 0;
+}
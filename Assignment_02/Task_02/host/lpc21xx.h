@@ -0,0 +1,29 @@
+/*
+ * Host stand-in for the LPC21xx registers used by ../uart_tx.c.  The
+ * transmit holding register and the line status register go to the UART
+ * model of uart_tx_sim.c, the other registers are plain variables.
+ */
+
+#ifndef LPC21XX_H_HOST
+#define LPC21XX_H_HOST
+
+// The driver would take GCC's interrupt attribute, which means something else on the host
+#define __CC_ARM
+#define __irq
+
+// Slot written by the next U0THR store, see uart_tx_sim.c
+extern unsigned char *pucSimUartWrite( void );
+extern unsigned long ulSimUartReadLsr( void );
+
+extern volatile unsigned long ulSimIer, ulSimIir, ulSimVectAddr, ulSimVectAddr1, ulSimVectCntl1, ulSimIntEnable;
+
+#define U0THR ( *pucSimUartWrite() )
+#define U0LSR ( ulSimUartReadLsr() )
+#define U0IER ulSimIer
+#define U0IIR ulSimIir
+#define VICVectAddr ulSimVectAddr
+#define VICVectAddr1 ulSimVectAddr1
+#define VICVectCntl1 ulSimVectCntl1
+#define VICIntEnable ulSimIntEnable
+
+#endif /* LPC21XX_H_HOST */
@@ -0,0 +1,30 @@
+/*
+ * Host stand-in for the task.h of the kernel, see FreeRTOS.h in this
+ * directory.  The simulation runs the writer and the interrupt in turns in
+ * one thread, so the critical sections have nothing to mask, and it never
+ * calls xUartTxFlush(): the notifications are never waited for.
+ */
+
+#ifndef TASK_H_HOST
+#define TASK_H_HOST
+
+#include "FreeRTOS.h"
+
+typedef void * TaskHandle_t;
+
+typedef struct
+{
+	BaseType_t xOverflowCount;
+	TickType_t xTimeOnEntering;
+} TimeOut_t;
+
+#define taskENTER_CRITICAL()
+#define taskEXIT_CRITICAL()
+
+#define xTaskGetCurrentTaskHandle() ( ( TaskHandle_t ) NULL )
+#define vTaskNotifyGiveFromISR( xTask, pxWoken ) ( ( void ) ( xTask ), ( void ) ( pxWoken ) )
+#define ulTaskNotifyTake( xClear, xTicks ) ( ( void ) ( xClear ), ( void ) ( xTicks ), 0UL )
+#define vTaskSetTimeOutState( pxTimeOut ) ( ( void ) ( pxTimeOut ) )
+#define xTaskCheckForTimeOut( pxTimeOut, pxTicks ) ( ( void ) ( pxTimeOut ), ( void ) ( pxTicks ), pdTRUE )
+
+#endif /* TASK_H_HOST */
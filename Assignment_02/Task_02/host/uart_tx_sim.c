@@ -0,0 +1,307 @@
+/*
+ * Host harness of the interrupt-driven UART transmit driver (see
+ * ../uart_tx.h) against the spin-wait transmit it replaced.
+ *
+ * ../uart_tx.c is built unchanged against the stand-in headers of this
+ * directory.  The UART model runs on the host clock at 115200 baud, 10 bits
+ * a character: a 16-byte FIFO in front of a shift register, THRE set while
+ * the FIFO is empty, and a THRE interrupt each time it empties with
+ * UART_IER_THRE set, which calls the driver's handler.  A write to a full
+ * FIFO is counted as an overrun.
+ *
+ * Both paths send the messages of the tasks of main.c ("Task 1 - Message x",
+ * 10 per burst):
+ *
+ *  - spin-wait: the task loads the FIFO whenever THRE is set and spins on
+ *    the line status until the transmitter can take the next message, which
+ *    is what the delay loop after vSerialPutString() stood for,
+ *  - ring: the task queues the messages with xUartTxWrite(), and sleeps
+ *    while the ring is full, as it would in xUartTxFlush(); between the
+ *    interrupts the harness sleeps too, the CPU being free for other tasks.
+ *
+ * For each path the harness reports the bytes/s on the line and the process
+ * CPU time, and checks that the bytes on the line are the bytes written.
+ * Both CPU times include the host clock reads of the UART model.  The CPU
+ * figures are host figures: the share of the CPU each path keeps carries
+ * over to the target, the microseconds do not.
+ *
+ *     gcc -O2 -I. -o uart_tx_sim uart_tx_sim.c
+ *     ./uart_tx_sim
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "../uart_tx.c"
+
+#define SIM_BAUD_RATE 115200ULL
+#define SIM_BITS_PER_CHAR 10ULL
+#define SIM_CHAR_NS ( ( 1000000000ULL * SIM_BITS_PER_CHAR ) / SIM_BAUD_RATE )
+
+// Messages per burst and bursts per run
+#define SIM_MESSAGES 10
+#define SIM_BURSTS 20
+
+// Longest run of bytes kept for the check
+#define SIM_LINE_LEN 8192
+
+// Type definitions
+typedef struct
+{
+	unsigned long long ullLastStart; // Time the last byte written moves to the shift register
+	unsigned long ulWritten; // Bytes written to the THR
+	unsigned long ulOverruns; // Writes to a full FIFO
+	unsigned long ulInterrupts;
+	int iInterruptArmed; // The FIFO went non-empty since the last interrupt
+	unsigned char ucLine[ SIM_LINE_LEN ];
+} SimUart_st;
+
+typedef struct
+{
+	const char *pcName;
+	double dWallSeconds;
+	double dCpuSeconds;
+	unsigned long ulBytes;
+} SimResult_st;
+
+// Global Variables
+volatile unsigned long ulSimIer, ulSimIir, ulSimVectAddr, ulSimVectAddr1, ulSimVectCntl1, ulSimIntEnable;
+static SimUart_st xSimUart;
+static unsigned char ucSimDiscard;
+static unsigned char ucSimExpected[ SIM_LINE_LEN ];
+static unsigned long ulSimExpectedLen;
+
+/*-----------------------------------------------------------*/
+
+static unsigned long long prvNowNs( clockid_t xClock )
+{
+	struct timespec xTime;
+
+	clock_gettime( xClock, &xTime );
+
+	return ( ( unsigned long long ) xTime.tv_sec * 1000000000ULL ) + ( unsigned long long ) xTime.tv_nsec;
+}
+/*-----------------------------------------------------------*/
+
+static void prvSleepUntilNs( unsigned long long ullWake )
+{
+	struct timespec xTime;
+
+	xTime.tv_sec = ( time_t ) ( ullWake / 1000000000ULL );
+	xTime.tv_nsec = ( long ) ( ullWake % 1000000000ULL );
+
+	while( clock_nanosleep( CLOCK_MONOTONIC, TIMER_ABSTIME, &xTime, NULL ) != 0 )
+	{
+	}
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * Bytes still in the FIFO, the one in the shift register excluded.
+ */
+static unsigned long prvSimUartFifoLevel( unsigned long long ullNow )
+{
+	if( xSimUart.ullLastStart <= ullNow )
+	{
+		return 0;
+	}
+
+	return ( unsigned long ) ( ( xSimUart.ullLastStart - ullNow + SIM_CHAR_NS - 1 ) / SIM_CHAR_NS );
+}
+/*-----------------------------------------------------------*/
+
+unsigned char *pucSimUartWrite( void )
+{
+	unsigned long long ullNow = prvNowNs( CLOCK_MONOTONIC );
+	unsigned long long ullStart = xSimUart.ullLastStart + SIM_CHAR_NS;
+
+	if( prvSimUartFifoLevel( ullNow ) >= UART_FIFO_LEN )
+	{
+		xSimUart.ulOverruns++;
+		return &ucSimDiscard;
+	}
+
+	// Straight to the shift register when it is idle
+	xSimUart.ullLastStart = ( ullStart > ullNow ) ? ullStart : ullNow;
+	xSimUart.iInterruptArmed = 1;
+
+	if( xSimUart.ulWritten >= SIM_LINE_LEN )
+	{
+		return &ucSimDiscard;
+	}
+
+	return &xSimUart.ucLine[ xSimUart.ulWritten++ ];
+}
+/*-----------------------------------------------------------*/
+
+unsigned long ulSimUartReadLsr( void )
+{
+	return ( prvSimUartFifoLevel( prvNowNs( CLOCK_MONOTONIC ) ) == 0 ) ? UART_LSR_THRE : 0;
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * Sleeps until the FIFO empties and runs the THRE interrupt.  Returns 0 if
+ * no interrupt is due.
+ */
+static int prvSimUartWaitInterrupt( void )
+{
+	if( ( xSimUart.iInterruptArmed == 0 ) || ( ( ulSimIer & UART_IER_THRE ) == 0 ) )
+	{
+		return 0;
+	}
+
+	prvSleepUntilNs( xSimUart.ullLastStart );
+	xSimUart.iInterruptArmed = 0;
+	xSimUart.ulInterrupts++;
+	prvUartTxISR();
+
+	return 1;
+}
+/*-----------------------------------------------------------*/
+
+static void prvSimUartReset( void )
+{
+	memset( &xSimUart, 0, sizeof( xSimUart ) );
+	ulSimIer = 0;
+}
+/*-----------------------------------------------------------*/
+
+static void prvMessage( char *pcMessage, unsigned int uiId )
+{
+	strcpy( pcMessage, "Task 1 - Message x\n" );
+	pcMessage[ 17 ] = ( char ) ( '0' + uiId );
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * Old path: loads the FIFO on THRE and spins until the message is out of it.
+ */
+static void prvSpinWrite( const char *pcMessage, unsigned int uiLength )
+{
+	unsigned int uiIndex = 0, uiChunk;
+
+	while( uiIndex < uiLength )
+	{
+		while( ( U0LSR & UART_LSR_THRE ) == 0 )
+		{
+		}
+
+		for( uiChunk = 0; ( uiChunk < UART_FIFO_LEN ) && ( uiIndex < uiLength ); uiChunk++ )
+		{
+			U0THR = ( unsigned char ) pcMessage[ uiIndex++ ];
+		}
+	}
+
+	// Until the transmitter can take the next message
+	while( ( U0LSR & UART_LSR_THRE ) == 0 )
+	{
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvRun( SimResult_st *pxResult, int iRing )
+{
+	char cMessage[ 32 ];
+	unsigned long long ullWallStart, ullCpuStart;
+	unsigned int uiBurst, uiId, uiLength;
+
+	prvSimUartReset();
+	ulSimExpectedLen = 0;
+
+	if( iRing != 0 )
+	{
+		vUartTxInit();
+	}
+
+	ullWallStart = prvNowNs( CLOCK_MONOTONIC );
+	ullCpuStart = prvNowNs( CLOCK_PROCESS_CPUTIME_ID );
+
+	for( uiBurst = 0; uiBurst < SIM_BURSTS; uiBurst++ )
+	{
+		for( uiId = 0; uiId < SIM_MESSAGES; uiId++ )
+		{
+			prvMessage( cMessage, uiId );
+			uiLength = ( unsigned int ) strlen( cMessage );
+			memcpy( &ucSimExpected[ ulSimExpectedLen ], cMessage, uiLength );
+			ulSimExpectedLen += uiLength;
+
+			if( iRing == 0 )
+			{
+				prvSpinWrite( cMessage, uiLength );
+			}
+			else
+			{
+				while( xUartTxWrite( cMessage, uiLength ) != pdPASS )
+				{
+					( void ) prvSimUartWaitInterrupt();
+				}
+			}
+		}
+	}
+
+	// Drain the ring, then wait for the last character on the line
+	while( prvSimUartWaitInterrupt() != 0 )
+	{
+	}
+
+	pxResult->dCpuSeconds = ( double ) ( prvNowNs( CLOCK_PROCESS_CPUTIME_ID ) - ullCpuStart ) * 1e-9;
+	prvSleepUntilNs( xSimUart.ullLastStart + SIM_CHAR_NS );
+	pxResult->dWallSeconds = ( double ) ( prvNowNs( CLOCK_MONOTONIC ) - ullWallStart ) * 1e-9;
+	pxResult->ulBytes = xSimUart.ulWritten;
+}
+/*-----------------------------------------------------------*/
+
+static int prvCheck( const SimResult_st *pxResult )
+{
+	if( xSimUart.ulOverruns != 0 )
+	{
+		fprintf( stderr, "%s: %lu FIFO overruns\n", pxResult->pcName, xSimUart.ulOverruns );
+		return 0;
+	}
+
+	if( ( xSimUart.ulWritten != ulSimExpectedLen ) || ( memcmp( xSimUart.ucLine, ucSimExpected, ulSimExpectedLen ) != 0 ) )
+	{
+		fprintf( stderr, "%s: the line does not carry the bytes written\n", pxResult->pcName );
+		return 0;
+	}
+
+	return 1;
+}
+/*-----------------------------------------------------------*/
+
+int main( void )
+{
+	SimResult_st xResults[ 2 ] = { { "spin-wait", 0.0, 0.0, 0 }, { "ring", 0.0, 0.0, 0 } };
+	unsigned long ulInterrupts[ 2 ];
+	int iPath;
+
+	for( iPath = 0; iPath < 2; iPath++ )
+	{
+		prvRun( &xResults[ iPath ], iPath );
+
+		if( !prvCheck( &xResults[ iPath ] ) )
+		{
+			return 1;
+		}
+
+		ulInterrupts[ iPath ] = xSimUart.ulInterrupts;
+	}
+
+	printf( "%d messages of 19 bytes, %llu baud, line limit %.0f bytes/s\n", SIM_BURSTS * SIM_MESSAGES, SIM_BAUD_RATE, 1e9 / SIM_CHAR_NS );
+	printf( "path       bytes/s  CPU ms  CPU share  CPU us/message  interrupts\n" );
+
+	for( iPath = 0; iPath < 2; iPath++ )
+	{
+		printf( "%-9s  %7.0f  %6.2f  %8.2f%%  %14.2f  %10lu\n", xResults[ iPath ].pcName,
+				xResults[ iPath ].ulBytes / xResults[ iPath ].dWallSeconds,
+				xResults[ iPath ].dCpuSeconds * 1e3,
+				100.0 * xResults[ iPath ].dCpuSeconds / xResults[ iPath ].dWallSeconds,
+				xResults[ iPath ].dCpuSeconds * 1e6 / ( SIM_BURSTS * SIM_MESSAGES ),
+				ulInterrupts[ iPath ] );
+	}
+
+	return 0;
+}
@@ -0,0 +1,207 @@
+/*
+ * Deferred binary log, see log.h.
+ */
+
+/* Scheduler includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "uart_tx.h"
+#include "log.h"
+
+#define LOG_FORMAT_ARGC(ID, ARGC, FORMAT) ARGC,
+
+// The drain task masks the offsets and empties the whole log ring into an idle UART ring
+#if ( ( LOG_RING_LEN & ( LOG_RING_LEN - 1 ) ) != 0 )
+#error "LOG_RING_LEN must be a power of two"
+#endif
+
+#if ( LOG_RING_LEN > UART_TX_RING_LEN )
+#error "LOG_RING_LEN must not exceed UART_TX_RING_LEN"
+#endif
+
+// Global Variables
+static const uint8_t ucLogArgCount[ LOG_ID_COUNT ] = { LOG_FORMAT_TABLE(LOG_FORMAT_ARGC) };
+static uint8_t ucLogRing[ LOG_RING_LEN ];
+static volatile UBaseType_t uxLogHead = 0; // Bytes recorded since start, written inside critical sections
+static volatile UBaseType_t uxLogTail = 0; // Bytes shipped since start, written by the drain task
+static uint32_t ulLogDropped = 0;
+
+// Prototypes
+static void prvLogPut( LogId_t xId, TickType_t xTime, const uint32_t *pulArgs );
+static void prvLogDrainTask( void *pvParameters );
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Copies one record into the ring, or counts it as dropped.  Called inside a
+ * critical section.
+ */
+static void prvLogPut( LogId_t xId, TickType_t xTime, const uint32_t *pulArgs )
+{
+	UBaseType_t uxArgCount = ucLogArgCount[ xId ];
+	UBaseType_t uxHead = uxLogHead, uxIndex;
+	uint32_t ulArg;
+
+	// Room for the longest encoding, checked once up front
+	if( ( LOG_RING_LEN - ( uxHead - uxLogTail ) ) < ( LOG_HEADER_LEN + ( uxArgCount * LOG_ARG_MAX_LEN ) ) )
+	{
+		ulLogDropped++;
+		return;
+	}
+
+	ucLogRing[ uxHead++ & ( LOG_RING_LEN - 1 ) ] = LOG_SYNC_BYTE;
+	ucLogRing[ uxHead++ & ( LOG_RING_LEN - 1 ) ] = ( uint8_t ) xId;
+	ucLogRing[ uxHead++ & ( LOG_RING_LEN - 1 ) ] = ( uint8_t ) xTime;
+	ucLogRing[ uxHead++ & ( LOG_RING_LEN - 1 ) ] = ( uint8_t ) ( xTime >> 8 );
+
+	for( uxIndex = 0; uxIndex < uxArgCount; uxIndex++ )
+	{
+		ulArg = pulArgs[ uxIndex ];
+
+		while( ulArg >= 0x80UL )
+		{
+			ucLogRing[ uxHead++ & ( LOG_RING_LEN - 1 ) ] = ( uint8_t ) ( ulArg | 0x80UL );
+			ulArg >>= 7;
+		}
+
+		ucLogRing[ uxHead++ & ( LOG_RING_LEN - 1 ) ] = ( uint8_t ) ulArg;
+	}
+
+	uxLogHead = uxHead;
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * Ships the recorded bytes to the UART ring, one contiguous piece at a time,
+ * each cut to the room left in the UART ring.  What does not fit stays in the
+ * log ring until the next period.
+ */
+static void prvLogDrainTask( void *pvParameters )
+{
+	TickType_t xLastWakeTime = xTaskGetTickCount();
+	UBaseType_t uxHead, uxTail, uxOffset, uxLength, uxRoom;
+	uint32_t ulReported = 0, ulDropped;
+
+	( void ) pvParameters;
+
+	for( ;; )
+	{
+		vTaskDelayUntil( &xLastWakeTime, LOG_DRAIN_PERIOD );
+
+		// Records go in whole, so everything below the head is complete records.
+		// This task is the only writer of the UART ring: a record cut by the ring
+		// wrap or by a full UART ring goes on where it stopped, the byte stream
+		// stays in order.
+		for( ;; )
+		{
+			uxHead = uxLogHead;
+			uxTail = uxLogTail;
+			uxRoom = UART_TX_RING_LEN - uxUartTxPending();
+
+			if( ( uxHead == uxTail ) || ( uxRoom == 0 ) )
+			{
+				break;
+			}
+
+			uxOffset = uxTail & ( LOG_RING_LEN - 1 );
+			uxLength = uxHead - uxTail;
+
+			if( uxLength > ( LOG_RING_LEN - uxOffset ) )
+			{
+				uxLength = LOG_RING_LEN - uxOffset;
+			}
+
+			// Room only grows until the write, the interrupt just takes bytes out
+			if( uxLength > uxRoom )
+			{
+				uxLength = uxRoom;
+			}
+
+			if( xUartTxWrite( ( const char * ) &ucLogRing[ uxOffset ], uxLength ) != pdPASS )
+			{
+				break;
+			}
+
+			uxLogTail = uxTail + uxLength;
+		}
+
+		// Tell the host about the records it will never see
+		ulDropped = ulLogDropped;
+
+		if( ulDropped != ulReported )
+		{
+			LOG1( LOG_ID_RECORDS_LOST, ulDropped - ulReported );
+			ulReported = ulDropped;
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xLogInit( UBaseType_t uxDrainPriority )
+{
+	return xTaskCreate( prvLogDrainTask, "LogDrain", configMINIMAL_STACK_SIZE, NULL, uxDrainPriority, NULL );
+}
+/*-----------------------------------------------------------*/
+
+void vLogWrite( LogId_t xId,
+                const uint32_t * pulArgs )
+{
+	configASSERT( xId < LOG_ID_COUNT );
+
+	taskENTER_CRITICAL();
+	{
+		prvLogPut( xId, xTaskGetTickCount(), pulArgs );
+	}
+	taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+void vLogWriteBlock( LogId_t xId,
+                     const uint32_t * pulArgs,
+                     UBaseType_t uxCount )
+{
+	UBaseType_t uxArgCount, uxIndex;
+
+	configASSERT( xId < LOG_ID_COUNT );
+
+	uxArgCount = ucLogArgCount[ xId ];
+
+	taskENTER_CRITICAL();
+	{
+		// Room for the whole block, so prvLogPut() never drops a record of it
+		if( ( LOG_RING_LEN - ( uxLogHead - uxLogTail ) ) < ( uxCount * ( LOG_HEADER_LEN + ( uxArgCount * LOG_ARG_MAX_LEN ) ) ) )
+		{
+			ulLogDropped += uxCount;
+		}
+		else
+		{
+			for( uxIndex = 0; uxIndex < uxCount; uxIndex++ )
+			{
+				prvLogPut( xId, xTaskGetTickCount(), &pulArgs[ uxIndex * uxArgCount ] );
+			}
+		}
+	}
+	taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+void vLogWriteFromISR( LogId_t xId,
+                       const uint32_t * pulArgs )
+{
+	UBaseType_t uxSavedInterruptStatus;
+
+	configASSERT( xId < LOG_ID_COUNT );
+
+	uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+	{
+		prvLogPut( xId, xTaskGetTickCountFromISR(), pulArgs );
+	}
+	taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+}
+/*-----------------------------------------------------------*/
+
+uint32_t ulLogGetDroppedCount( void )
+{
+	return ulLogDropped;
+}
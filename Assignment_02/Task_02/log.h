@@ -0,0 +1,67 @@
+/*
+ * Deferred binary log.
+ *
+ * A log call stores a format ID, the low 16 bits of the tick count and its
+ * raw arguments into a RAM ring, nothing is formatted on the target.  A low
+ * priority drain task hands the packed records to the UART transmit ring
+ * (uart_tx.h) and host/log_decode.c turns the byte stream back into text.
+ *
+ * Records that do not fit in the ring are dropped, the drain task reports how
+ * many with a LOG_ID_RECORDS_LOST record.
+ */
+
+#ifndef LOG_H
+#define LOG_H
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "log_formats.h"
+
+// Log ring size in bytes, a power of two no larger than UART_TX_RING_LEN
+#ifndef LOG_RING_LEN
+#define LOG_RING_LEN 256
+#endif
+
+// Ticks between two runs of the drain task
+#ifndef LOG_DRAIN_PERIOD
+#define LOG_DRAIN_PERIOD 10
+#endif
+
+/*
+ * Creates the drain task at uxDrainPriority, normally just above idle.
+ * vUartTxInit() must have been called.  Returns pdPASS or pdFAIL.
+ */
+BaseType_t xLogInit( UBaseType_t uxDrainPriority );
+
+/*
+ * Records xId with the first N arguments of pulArgs, N being the argument
+ * count given in the format table.  Never blocks.
+ */
+void vLogWrite( LogId_t xId,
+                const uint32_t * pulArgs );
+void vLogWriteFromISR( LogId_t xId,
+                       const uint32_t * pulArgs );
+
+/*
+ * Records uxCount records of xId in one go, pulArgs holding the arguments of
+ * each record in turn.  They are all recorded or all dropped, with no other
+ * record in between.  Never blocks.
+ */
+void vLogWriteBlock( LogId_t xId,
+                     const uint32_t * pulArgs,
+                     UBaseType_t uxCount );
+
+// Shorthands for the common argument counts
+#define LOG0(xId) vLogWrite((xId), NULL)
+#define LOG1(xId, ulArg0) \
+	do { uint32_t ulLogArgs[1]; ulLogArgs[0] = (uint32_t)(ulArg0); vLogWrite((xId), ulLogArgs); } while(0)
+#define LOG2(xId, ulArg0, ulArg1) \
+	do { uint32_t ulLogArgs[2]; ulLogArgs[0] = (uint32_t)(ulArg0); ulLogArgs[1] = (uint32_t)(ulArg1); vLogWrite((xId), ulLogArgs); } while(0)
+
+/*
+ * Number of records dropped because the ring was full.
+ */
+uint32_t ulLogGetDroppedCount( void );
+
+#endif /* LOG_H */
@@ -0,0 +1,38 @@
+/*
+ * Format strings of the deferred log, shared by the target and the host
+ * decoder (host/log_decode.c).
+ *
+ * X( ID, argument count, format ) -- every argument is a 32-bit unsigned
+ * value, printed by the host with the format.  The target only sees the IDs
+ * and argument counts, the strings never reach its image.
+ * Append new entries at the end, an ID is its position in the table.
+ */
+
+#ifndef LOG_FORMATS_H
+#define LOG_FORMATS_H
+
+#define LOG_FORMAT_TABLE(X) \
+	X(LOG_ID_RECORDS_LOST, 1, "%lu log records lost\n") \
+	X(LOG_ID_TASK_MESSAGE, 2, "Task %lu - Message %lu\n")
+
+// Max number of arguments of one record
+#define LOG_MAX_ARGS 4
+
+// First byte of every record, lets the host find the next record after garbage
+#define LOG_SYNC_BYTE 0xA5
+
+// Record: sync, ID, tick count (16 bits, little endian), then each argument
+// as a varint: 7 bits per byte, low bits first, top bit set on all but the last
+// byte, so small values take a single byte
+#define LOG_HEADER_LEN 4
+#define LOG_ARG_MAX_LEN 5
+
+#define LOG_FORMAT_ID(ID, ARGC, FORMAT) ID,
+
+typedef enum
+{
+	LOG_FORMAT_TABLE(LOG_FORMAT_ID)
+	LOG_ID_COUNT
+} LogId_t;
+
+#endif /* LOG_FORMATS_H */
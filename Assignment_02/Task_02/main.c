@@ -67,7 +67,8 @@
 #include "GPIO.h"
 
 // More Application includes
-#include "semphr.h"
+#include "uart_tx.h"
+#include "log.h"
 
 
 /*-----------------------------------------------------------*/
@@ -78,15 +79,14 @@
 /* Constants for the ComTest demo application tasks. */
 #define mainCOM_TEST_BAUD_RATE	( ( unsigned long ) 115200 )
 
-// Macro to change int to char
-#define INT_TO_CHAR(number) ((char)(number + '0'))
+// Priority of the log drain task, the lowest application priority
+#define LOG_DRAIN_PRIORITY 1
 
-// Constant to indicate mutex polling
-#define NO_TIMEOUT ((TickType_t) 0)
+// Messages sent by a task in one block
+#define MESSAGES_PER_BLOCK 10
 
 // Global Variables
 TaskHandle_t task1_handle = NULL, task2_handle = NULL;
-SemaphoreHandle_t mutex = NULL;
 
 
 /*
@@ -111,8 +111,12 @@ int main( void )
 	/* Setup the hardware for use with the Keil demo board. */
 	prvSetupHardware();
 	
-	// Create Mutex
-	mutex = xSemaphoreCreateMutex();
+	// Start the log drain task, the only task writing to the UART
+	if(xLogInit(LOG_DRAIN_PRIORITY) != pdPASS)
+	{
+		// Not enough heap for the drain task
+		for( ;; );
+	}
 	
   	/* Create Tasks here */
 	// Task 1
@@ -154,6 +158,9 @@ static void prvSetupHardware( void )
 
 	/* Configure UART */
 	xSerialPortInitMinimal(mainCOM_TEST_BAUD_RATE);
+	
+	/* Interrupt-driven transmit */
+	vUartTxInit();
 
 	/* Configure GPIO */
 	GPIO_init();
@@ -165,42 +172,21 @@ static void prvSetupHardware( void )
 
 void task1_code(void *task_parameters)
 {
-	// Message body
-	char message[] = "Task 1 - Message x\n";
-	
-	// Message length (calculated once to save runtime)
-	uint8_t message_len = (uint8_t)strlen(message);
-	
-	// Message ID (variable in message body from 0 to 9)
+	// Arguments of the block: task number and message ID of each message
+	uint32_t block[MESSAGES_PER_BLOCK * 2];
 	uint8_t message_ID = 0;
-
-	// Loop index to make a delay loop until UART is ready to send again
-	volatile uint32_t delay_loop_index;
 	
 	while(1)
 	{
-		// Take Mutex to access the shared resource (UART1)
-		// NO_TIMEOUT to poll, portMAX_DELAY to block
-		if(xSemaphoreTake(mutex, portMAX_DELAY) == pdTRUE)
+		for(message_ID = 0; message_ID < MESSAGES_PER_BLOCK; message_ID++)
 		{
-			for(message_ID = 0; message_ID < 10; message_ID++)
-			{
-				// Update message ID in message body
-				message[message_len - 2] = INT_TO_CHAR(message_ID);
+			block[message_ID * 2] = 1;
+			block[(message_ID * 2) + 1] = message_ID;
 			
-				// Send Message
-				vSerialPutString((const signed char *)message, message_len);
-
-				// Delay loop
-				for(delay_loop_index = 0; delay_loop_index < 10000; delay_loop_index++);
-				
-			} // for
-			
-			// Give back the mutex so that the shared resource 
-			// can be accessed by other tasks
-			xSemaphoreGive(mutex);
-			
-		} // if
+		} // for
+		
+		// Log "Task 1 - Message <ID>" for the 10 IDs in one block, the drain task sends it in the background
+		vLogWriteBlock(LOG_ID_TASK_MESSAGE, block, MESSAGES_PER_BLOCK);
 		
 		// Periodicity = 100 ms
 		vTaskDelay(100);
@@ -211,53 +197,30 @@ void task1_code(void *task_parameters)
 
 void task2_code(void *task_parameters)
 {
-	// Message body
-	char message[] = "Task 2 - Message x\n";
-	
-	// Message length (calculated once to save runtime)
-	uint8_t message_len = (uint8_t)strlen(message);
-	
-	// Message ID (variable in message body from 0 to 9)
+	// Arguments of the block: task number and message ID of each message
+	uint32_t block[MESSAGES_PER_BLOCK * 2];
 	uint8_t message_ID = 0;
-
-	// Loop index to make a delay loop until UART is ready to send again
-	volatile uint32_t delay_loop_index;
 	
 	// Loop index to simulate heavy load
 	volatile uint32_t heavy_load_index;
 	
 	while(1)
 	{
-		// Take Mutex to access the shared resource (UART1)
-		// NO_TIMEOUT to poll, portMAX_DELAY to block
-		if(xSemaphoreTake(mutex, portMAX_DELAY) == pdTRUE)
+		for(message_ID = 0; message_ID < MESSAGES_PER_BLOCK; message_ID++)
 		{
-			for(message_ID = 0; message_ID < 10; message_ID++)
-			{
-				// Update message ID in message body
-				message[message_len - 2] = INT_TO_CHAR(message_ID);
-			
-				// Send Message
-				vSerialPutString((const signed char *)message, message_len);
-
-				// Delay loop
-				for(delay_loop_index = 0; delay_loop_index < 10000; delay_loop_index++);
-			
-				// Heavy Load loop
-				for(heavy_load_index = 0; heavy_load_index < 100000; heavy_load_index++);
-				
-				
-			} // for
+			block[message_ID * 2] = 2;
+			block[(message_ID * 2) + 1] = message_ID;
 			
-			// Give back the mutex so that the shared resource 
-			// can be accessed by other tasks
-			xSemaphoreGive(mutex);
+			// Heavy Load loop, nothing is locked meanwhile
+			for(heavy_load_index = 0; heavy_load_index < 100000; heavy_load_index++);
 			
-		} // if
+		} // for
+		
+		// Log the 10 messages in one block, Task 1 can not interleave its own
+		vLogWriteBlock(LOG_ID_TASK_MESSAGE, block, MESSAGES_PER_BLOCK);
 		
 		// Periodicity = 500 ms
 		vTaskDelay(500);
 		
 	} // while
 }
-
@@ -0,0 +1,175 @@
+/*
+ * Interrupt-driven UART transmit driver, see uart_tx.h.
+ */
+
+/* Scheduler includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "lpc21xx.h"
+
+#include "uart_tx.h"
+
+// UART0 registers and VIC channel, change them together to use UART1
+#define UART_THR U0THR
+#define UART_LSR U0LSR
+#define UART_IER U0IER
+#define UART_IIR U0IIR
+#define UART_VIC_CHANNEL 6
+
+// Vectored interrupt slot used by the driver
+#define UART_VIC_VECT_ADDR VICVectAddr1
+#define UART_VIC_VECT_CNTL VICVectCntl1
+
+#define UART_LSR_THRE 0x20 // Transmit FIFO empty
+#define UART_IER_THRE 0x02 // Interrupt when the transmit FIFO empties
+#define UART_FIFO_LEN 16
+#define VIC_VECT_ENABLE 0x20
+
+// Plain IRQ handler, it never switches context itself
+#if defined( __CC_ARM )
+#define UART_TX_IRQ __irq
+#else
+#define UART_TX_IRQ __attribute__ ( ( interrupt( "IRQ" ) ) )
+#endif
+
+// Global Variables
+static char cTxRing[ UART_TX_RING_LEN ];
+static volatile UBaseType_t uxTxHead = 0; // Bytes queued since start, written by the tasks
+static volatile UBaseType_t uxTxTail = 0; // Bytes sent since start, written by the interrupt
+static TaskHandle_t xTxWaiter = NULL; // Task blocked in xUartTxFlush()
+
+// Prototypes
+static UBaseType_t prvUartTxFillFifo( void );
+static void UART_TX_IRQ prvUartTxISR( void );
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Moves up to a FIFO worth of bytes from the ring to the UART.  Called with
+ * the UART interrupt masked, from the interrupt or a critical section.
+ */
+static UBaseType_t prvUartTxFillFifo( void )
+{
+	UBaseType_t uxSent = 0;
+
+	while( ( uxTxTail != uxTxHead ) && ( uxSent < UART_FIFO_LEN ) )
+	{
+		UART_THR = cTxRing[ uxTxTail & ( UART_TX_RING_LEN - 1 ) ];
+		uxTxTail++;
+		uxSent++;
+	}
+
+	return uxSent;
+}
+/*-----------------------------------------------------------*/
+
+static void UART_TX_IRQ prvUartTxISR( void )
+{
+	BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+	// Reading the IIR clears the THRE interrupt
+	( void ) UART_IIR;
+
+	// Nothing left to send and the FIFO just emptied: wake the flushing task,
+	// it runs from the next tick since this handler does not switch context
+	if( ( prvUartTxFillFifo() == 0 ) && ( xTxWaiter != NULL ) )
+	{
+		vTaskNotifyGiveFromISR( xTxWaiter, &xHigherPriorityTaskWoken );
+		xTxWaiter = NULL;
+	}
+
+	// End of interrupt for the VIC
+	VICVectAddr = 0;
+}
+/*-----------------------------------------------------------*/
+
+void vUartTxInit( void )
+{
+	UART_VIC_VECT_ADDR = ( unsigned long ) prvUartTxISR;
+	UART_VIC_VECT_CNTL = VIC_VECT_ENABLE | UART_VIC_CHANNEL;
+	VICIntEnable = ( 1UL << UART_VIC_CHANNEL );
+
+	UART_IER |= UART_IER_THRE;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xUartTxWrite( const char * pcData,
+                         UBaseType_t uxLength )
+{
+	UBaseType_t uxIndex;
+	BaseType_t xReturn = pdFAIL;
+
+	taskENTER_CRITICAL();
+	{
+		if( ( UART_TX_RING_LEN - ( uxTxHead - uxTxTail ) ) >= uxLength )
+		{
+			for( uxIndex = 0; uxIndex < uxLength; uxIndex++ )
+			{
+				cTxRing[ ( uxTxHead + uxIndex ) & ( UART_TX_RING_LEN - 1 ) ] = pcData[ uxIndex ];
+			}
+
+			uxTxHead += uxLength;
+
+			// An idle transmitter raises no interrupt, start it here
+			if( ( UART_LSR & UART_LSR_THRE ) != 0 )
+			{
+				( void ) prvUartTxFillFifo();
+			}
+
+			xReturn = pdPASS;
+		}
+	}
+	taskEXIT_CRITICAL();
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xUartTxFlush( TickType_t xTicksToWait )
+{
+	TimeOut_t xTimeOut;
+	BaseType_t xDrained;
+	TaskHandle_t xCurrentTask = xTaskGetCurrentTaskHandle();
+
+	vTaskSetTimeOutState( &xTimeOut );
+
+	for( ;; )
+	{
+		taskENTER_CRITICAL();
+		{
+			xDrained = ( ( uxTxTail == uxTxHead ) && ( ( UART_LSR & UART_LSR_THRE ) != 0 ) ) ? pdTRUE : pdFALSE;
+
+			if( xDrained == pdFALSE )
+			{
+				configASSERT( ( xTxWaiter == NULL ) || ( xTxWaiter == xCurrentTask ) );
+				xTxWaiter = xCurrentTask;
+			}
+		}
+		taskEXIT_CRITICAL();
+
+		if( ( xDrained != pdFALSE ) || ( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) != pdFALSE ) )
+		{
+			break;
+		}
+
+		// A stale notification only costs one more pass round the loop
+		( void ) ulTaskNotifyTake( pdTRUE, xTicksToWait );
+	}
+
+	taskENTER_CRITICAL();
+	{
+		if( xTxWaiter == xCurrentTask )
+		{
+			xTxWaiter = NULL;
+		}
+	}
+	taskEXIT_CRITICAL();
+
+	return xDrained;
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxUartTxPending( void )
+{
+	return uxTxHead - uxTxTail;
+}
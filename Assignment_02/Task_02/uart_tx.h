@@ -0,0 +1,52 @@
+/*
+ * Interrupt-driven UART transmit driver.
+ *
+ * Writers copy their bytes into a transmit ring and return at once, the UART
+ * "transmit holding register empty" interrupt refills the hardware FIFO from
+ * the ring.  A task that has to know when its bytes are out can block on
+ * xUartTxFlush() instead of spinning on a delay loop.
+ *
+ * The driver takes over the transmit path of the UART set up by
+ * xSerialPortInitMinimal(), do not mix it with vSerialPutString().
+ */
+
+#ifndef UART_TX_H
+#define UART_TX_H
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+// Transmit ring size in bytes, must be a power of two
+#ifndef UART_TX_RING_LEN
+#define UART_TX_RING_LEN 256
+#endif
+
+/*
+ * Installs the transmit interrupt.  Call once after xSerialPortInitMinimal()
+ * and before the scheduler starts.
+ */
+void vUartTxInit( void );
+
+/*
+ * Queues uxLength bytes for transmission without blocking.  The bytes are
+ * queued all together or not at all, so messages written by different tasks
+ * never interleave.  Returns pdPASS, or pdFAIL if the ring has no room for
+ * them (see xUartTxFlush()).
+ */
+BaseType_t xUartTxWrite( const char * pcData,
+                         UBaseType_t uxLength );
+
+/*
+ * Blocks the calling task until every queued byte has left the transmit FIFO,
+ * or for at most xTicksToWait.  Returns pdPASS once drained, pdFAIL on
+ * timeout.  Only one task may wait at a time, and the wakeup uses the task's
+ * default notification index.
+ */
+BaseType_t xUartTxFlush( TickType_t xTicksToWait );
+
+/*
+ * Number of bytes waiting in the ring.
+ */
+UBaseType_t uxUartTxPending( void );
+
+#endif /* UART_TX_H */
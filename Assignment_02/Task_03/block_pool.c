@@ -0,0 +1,188 @@
+/*
+ * Fixed-block memory pool, see block_pool.h.
+ */
+
+/* Scheduler includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "block_pool.h"
+
+// Type definitions
+typedef struct FreeBlock_st
+{
+	struct FreeBlock_st *pxNext;
+} FreeBlock_st;
+
+typedef struct BlockPool_st
+{
+	uint8_t *pucBlocks; // First block, used to check the blocks given back
+	size_t xBlockSize; // Rounded up to portBYTE_ALIGNMENT
+	UBaseType_t uxBlockCount;
+	FreeBlock_st *pxFreeList;
+	UBaseType_t uxFreeCount;
+	UBaseType_t uxMinimumFreeCount;
+	uint32_t ulExhaustedCount;
+} BlockPool_st;
+
+// Prototypes
+static void * prvBlockPoolPop( BlockPool_st *pxPool );
+static void prvBlockPoolPush( BlockPool_st *pxPool, void *pvBlock );
+
+/*-----------------------------------------------------------*/
+
+static void * prvBlockPoolPop( BlockPool_st *pxPool )
+{
+	FreeBlock_st *pxBlock = pxPool->pxFreeList;
+
+	if( pxBlock == NULL )
+	{
+		pxPool->ulExhaustedCount++;
+		return NULL;
+	}
+
+	pxPool->pxFreeList = pxBlock->pxNext;
+	pxPool->uxFreeCount--;
+
+	if( pxPool->uxFreeCount < pxPool->uxMinimumFreeCount )
+	{
+		pxPool->uxMinimumFreeCount = pxPool->uxFreeCount;
+	}
+
+	return pxBlock;
+}
+/*-----------------------------------------------------------*/
+
+static void prvBlockPoolPush( BlockPool_st *pxPool, void *pvBlock )
+{
+	FreeBlock_st *pxBlock = ( FreeBlock_st * ) pvBlock;
+
+	// The block must be one of ours
+	configASSERT( ( ( uint8_t * ) pvBlock >= pxPool->pucBlocks ) &&
+				  ( ( uint8_t * ) pvBlock < ( pxPool->pucBlocks + ( pxPool->uxBlockCount * pxPool->xBlockSize ) ) ) &&
+				  ( ( ( size_t ) ( ( uint8_t * ) pvBlock - pxPool->pucBlocks ) % pxPool->xBlockSize ) == 0 ) );
+	configASSERT( pxPool->uxFreeCount < pxPool->uxBlockCount );
+
+	pxBlock->pxNext = pxPool->pxFreeList;
+	pxPool->pxFreeList = pxBlock;
+	pxPool->uxFreeCount++;
+}
+/*-----------------------------------------------------------*/
+
+BlockPoolHandle_t xBlockPoolCreate( UBaseType_t uxBlockCount,
+                                    size_t xBlockSize )
+{
+	BlockPool_st *pxPool;
+	UBaseType_t uxIndex;
+
+	configASSERT( uxBlockCount > 0 );
+
+	// Every block must hold the free list link and keep the alignment
+	if( xBlockSize < sizeof( FreeBlock_st ) )
+	{
+		xBlockSize = sizeof( FreeBlock_st );
+	}
+
+	xBlockSize = ( xBlockSize + portBYTE_ALIGNMENT - 1 ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+
+	pxPool = ( BlockPool_st * ) pvPortMalloc( sizeof( BlockPool_st ) );
+
+	if( pxPool == NULL )
+	{
+		return NULL;
+	}
+
+	pxPool->pucBlocks = ( uint8_t * ) pvPortMalloc( uxBlockCount * xBlockSize );
+
+	if( pxPool->pucBlocks == NULL )
+	{
+		vPortFree( pxPool );
+		return NULL;
+	}
+
+	pxPool->xBlockSize = xBlockSize;
+	pxPool->uxBlockCount = uxBlockCount;
+	pxPool->pxFreeList = NULL;
+	pxPool->uxFreeCount = 0;
+	pxPool->ulExhaustedCount = 0;
+
+	for( uxIndex = uxBlockCount; uxIndex > 0; uxIndex-- )
+	{
+		prvBlockPoolPush( pxPool, &pxPool->pucBlocks[ ( uxIndex - 1 ) * xBlockSize ] );
+	}
+
+	pxPool->uxMinimumFreeCount = uxBlockCount;
+
+	return pxPool;
+}
+/*-----------------------------------------------------------*/
+
+void * pvBlockPoolAlloc( BlockPoolHandle_t xPool )
+{
+	void *pvBlock;
+
+	taskENTER_CRITICAL();
+	{
+		pvBlock = prvBlockPoolPop( xPool );
+	}
+	taskEXIT_CRITICAL();
+
+	return pvBlock;
+}
+/*-----------------------------------------------------------*/
+
+void * pvBlockPoolAllocFromISR( BlockPoolHandle_t xPool )
+{
+	void *pvBlock;
+	UBaseType_t uxSavedInterruptStatus;
+
+	uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+	{
+		pvBlock = prvBlockPoolPop( xPool );
+	}
+	taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+
+	return pvBlock;
+}
+/*-----------------------------------------------------------*/
+
+void vBlockPoolFree( BlockPoolHandle_t xPool,
+                     void * pvBlock )
+{
+	taskENTER_CRITICAL();
+	{
+		prvBlockPoolPush( xPool, pvBlock );
+	}
+	taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+void vBlockPoolFreeFromISR( BlockPoolHandle_t xPool,
+                            void * pvBlock )
+{
+	UBaseType_t uxSavedInterruptStatus;
+
+	uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+	{
+		prvBlockPoolPush( xPool, pvBlock );
+	}
+	taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxBlockPoolGetFreeCount( BlockPoolHandle_t xPool )
+{
+	return xPool->uxFreeCount;
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxBlockPoolGetMinimumFreeCount( BlockPoolHandle_t xPool )
+{
+	return xPool->uxMinimumFreeCount;
+}
+/*-----------------------------------------------------------*/
+
+uint32_t ulBlockPoolGetExhaustedCount( BlockPoolHandle_t xPool )
+{
+	return xPool->ulExhaustedCount;
+}
@@ -0,0 +1,52 @@
+/*
+ * Fixed-block memory pool.
+ *
+ * A pool holds a fixed number of blocks of the same size, carved out of one
+ * allocation when the pool is created.  Free blocks are chained in a LIFO
+ * list through their first word, so allocating and freeing are O(1) and safe
+ * to call from tasks and interrupts.
+ *
+ * Used for zero-copy message passing: the producer allocates a block, fills
+ * it and sends only the pointer through a queue, the consumer owns the block
+ * from then on and gives it back with vBlockPoolFree() when it is done.
+ */
+
+#ifndef BLOCK_POOL_H
+#define BLOCK_POOL_H
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+// Type definitions
+typedef struct BlockPool_st * BlockPoolHandle_t;
+
+/*
+ * Creates a pool of uxBlockCount blocks of at least xBlockSize bytes.
+ * Returns NULL if there is not enough heap.
+ */
+BlockPoolHandle_t xBlockPoolCreate( UBaseType_t uxBlockCount,
+                                    size_t xBlockSize );
+
+/*
+ * Returns a free block, or NULL if the pool is exhausted.
+ */
+void * pvBlockPoolAlloc( BlockPoolHandle_t xPool );
+void * pvBlockPoolAllocFromISR( BlockPoolHandle_t xPool );
+
+/*
+ * Gives back a block obtained from the same pool.
+ */
+void vBlockPoolFree( BlockPoolHandle_t xPool,
+                     void * pvBlock );
+void vBlockPoolFreeFromISR( BlockPoolHandle_t xPool,
+                            void * pvBlock );
+
+/*
+ * Statistics: blocks currently free, lowest number of free blocks seen since
+ * the pool was created, and number of allocations that failed.
+ */
+UBaseType_t uxBlockPoolGetFreeCount( BlockPoolHandle_t xPool );
+UBaseType_t uxBlockPoolGetMinimumFreeCount( BlockPoolHandle_t xPool );
+uint32_t ulBlockPoolGetExhaustedCount( BlockPoolHandle_t xPool );
+
+#endif /* BLOCK_POOL_H */
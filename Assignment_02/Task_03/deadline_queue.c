@@ -0,0 +1,347 @@
+/*
+ * Deadline-stamped message queue, see deadline_queue.h.
+ */
+
+/* Standard includes. */
+#include <string.h>
+
+/* Scheduler includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+
+#include "deadline_queue.h"
+
+// xA is more urgent than xB, safe across tick count overflow
+#define DEADLINE_BEFORE(xA, xB) ( ( TickType_t ) ( ( xA ) - ( xB ) ) > ( portMAX_DELAY >> 1 ) )
+
+// Type definitions
+typedef struct DeadlineQueue_st
+{
+	uint8_t *pucStorage; // uxLength heap slots followed by one scratch slot
+	UBaseType_t uxLength;
+	UBaseType_t uxItemSize;
+	UBaseType_t uxSlotSize; // Deadline + item
+	UBaseType_t uxCount;
+	BaseType_t xExpiredPolicy;
+	uint32_t ulExpiredCount;
+	SemaphoreHandle_t xItems; // Counts the items in the heap
+	SemaphoreHandle_t xSpaces; // Counts the free slots
+} DeadlineQueue_st;
+
+// Prototypes
+static TickType_t prvSlotDeadline( const DeadlineQueue_st *pxQueue, UBaseType_t uxSlot );
+static void prvSlotSwap( DeadlineQueue_st *pxQueue, UBaseType_t uxA, UBaseType_t uxB );
+static void prvHeapPush( DeadlineQueue_st *pxQueue, const void *pvItem, TickType_t xDeadline );
+static TickType_t prvHeapPop( DeadlineQueue_st *pxQueue, void *pvBuffer );
+
+#define SLOT(pxQueue, uxSlot) ( &( pxQueue )->pucStorage[ ( uxSlot ) * ( pxQueue )->uxSlotSize ] )
+
+/*-----------------------------------------------------------*/
+
+static TickType_t prvSlotDeadline( const DeadlineQueue_st *pxQueue, UBaseType_t uxSlot )
+{
+	TickType_t xDeadline;
+
+	memcpy( &xDeadline, SLOT( pxQueue, uxSlot ), sizeof( TickType_t ) );
+
+	return xDeadline;
+}
+/*-----------------------------------------------------------*/
+
+static void prvSlotSwap( DeadlineQueue_st *pxQueue, UBaseType_t uxA, UBaseType_t uxB )
+{
+	uint8_t *pucScratch = SLOT( pxQueue, pxQueue->uxLength );
+
+	memcpy( pucScratch, SLOT( pxQueue, uxA ), pxQueue->uxSlotSize );
+	memcpy( SLOT( pxQueue, uxA ), SLOT( pxQueue, uxB ), pxQueue->uxSlotSize );
+	memcpy( SLOT( pxQueue, uxB ), pucScratch, pxQueue->uxSlotSize );
+}
+/*-----------------------------------------------------------*/
+
+static void prvHeapPush( DeadlineQueue_st *pxQueue, const void *pvItem, TickType_t xDeadline )
+{
+	UBaseType_t uxSlot = pxQueue->uxCount, uxParent;
+
+	memcpy( SLOT( pxQueue, uxSlot ), &xDeadline, sizeof( TickType_t ) );
+	memcpy( SLOT( pxQueue, uxSlot ) + sizeof( TickType_t ), pvItem, pxQueue->uxItemSize );
+	pxQueue->uxCount++;
+
+	// Sift up
+	while( uxSlot > 0 )
+	{
+		uxParent = ( uxSlot - 1 ) / 2;
+
+		if( !DEADLINE_BEFORE( xDeadline, prvSlotDeadline( pxQueue, uxParent ) ) )
+		{
+			break;
+		}
+
+		prvSlotSwap( pxQueue, uxSlot, uxParent );
+		uxSlot = uxParent;
+	}
+}
+/*-----------------------------------------------------------*/
+
+static TickType_t prvHeapPop( DeadlineQueue_st *pxQueue, void *pvBuffer )
+{
+	UBaseType_t uxSlot = 0, uxChild;
+	TickType_t xDeadline = prvSlotDeadline( pxQueue, 0 );
+
+	memcpy( pvBuffer, SLOT( pxQueue, 0 ) + sizeof( TickType_t ), pxQueue->uxItemSize );
+	pxQueue->uxCount--;
+
+	// Move the last item to the root and sift it down
+	if( pxQueue->uxCount > 0 )
+	{
+		memcpy( SLOT( pxQueue, 0 ), SLOT( pxQueue, pxQueue->uxCount ), pxQueue->uxSlotSize );
+
+		for( ;; )
+		{
+			uxChild = ( 2 * uxSlot ) + 1;
+
+			if( uxChild >= pxQueue->uxCount )
+			{
+				break;
+			}
+
+			if( ( ( uxChild + 1 ) < pxQueue->uxCount ) &&
+				DEADLINE_BEFORE( prvSlotDeadline( pxQueue, uxChild + 1 ), prvSlotDeadline( pxQueue, uxChild ) ) )
+			{
+				uxChild++;
+			}
+
+			if( !DEADLINE_BEFORE( prvSlotDeadline( pxQueue, uxChild ), prvSlotDeadline( pxQueue, uxSlot ) ) )
+			{
+				break;
+			}
+
+			prvSlotSwap( pxQueue, uxSlot, uxChild );
+			uxSlot = uxChild;
+		}
+	}
+
+	return xDeadline;
+}
+/*-----------------------------------------------------------*/
+
+DeadlineQueueHandle_t xDeadlineQueueCreate( UBaseType_t uxLength,
+                                            UBaseType_t uxItemSize,
+                                            BaseType_t xExpiredPolicy )
+{
+	DeadlineQueue_st *pxQueue;
+
+	configASSERT( ( uxLength > 0 ) && ( uxItemSize > 0 ) );
+
+	pxQueue = ( DeadlineQueue_st * ) pvPortMalloc( sizeof( DeadlineQueue_st ) );
+
+	if( pxQueue == NULL )
+	{
+		return NULL;
+	}
+
+	pxQueue->uxLength = uxLength;
+	pxQueue->uxItemSize = uxItemSize;
+	pxQueue->uxSlotSize = sizeof( TickType_t ) + uxItemSize;
+	pxQueue->uxCount = 0;
+	pxQueue->xExpiredPolicy = xExpiredPolicy;
+	pxQueue->ulExpiredCount = 0;
+	pxQueue->pucStorage = ( uint8_t * ) pvPortMalloc( ( uxLength + 1 ) * pxQueue->uxSlotSize );
+	pxQueue->xItems = xSemaphoreCreateCounting( uxLength, 0 );
+	pxQueue->xSpaces = xSemaphoreCreateCounting( uxLength, uxLength );
+
+	if( ( pxQueue->pucStorage == NULL ) || ( pxQueue->xItems == NULL ) || ( pxQueue->xSpaces == NULL ) )
+	{
+		if( pxQueue->xItems != NULL )
+		{
+			vSemaphoreDelete( pxQueue->xItems );
+		}
+
+		if( pxQueue->xSpaces != NULL )
+		{
+			vSemaphoreDelete( pxQueue->xSpaces );
+		}
+
+		vPortFree( pxQueue->pucStorage );
+		vPortFree( pxQueue );
+		return NULL;
+	}
+
+	return pxQueue;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xDeadlineQueueSend( DeadlineQueueHandle_t xQueue,
+                               const void * pvItem,
+                               TickType_t xRelativeDeadline,
+                               TickType_t xTicksToWait )
+{
+	if( xSemaphoreTake( xQueue->xSpaces, xTicksToWait ) != pdTRUE )
+	{
+		return errQUEUE_FULL;
+	}
+
+	taskENTER_CRITICAL();
+	{
+		prvHeapPush( xQueue, pvItem, xTaskGetTickCount() + xRelativeDeadline );
+	}
+	taskEXIT_CRITICAL();
+
+	( void ) xSemaphoreGive( xQueue->xItems );
+
+	return pdPASS;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xDeadlineQueueReceive( DeadlineQueueHandle_t xQueue,
+                                  void * pvBuffer,
+                                  TickType_t * pxDeadline,
+                                  TickType_t xTicksToWait )
+{
+	TimeOut_t xTimeOut;
+	TickType_t xDeadline;
+	BaseType_t xExpired;
+
+	vTaskSetTimeOutState( &xTimeOut );
+
+	for( ;; )
+	{
+		if( xSemaphoreTake( xQueue->xItems, xTicksToWait ) != pdTRUE )
+		{
+			return errQUEUE_EMPTY;
+		}
+
+		taskENTER_CRITICAL();
+		{
+			xDeadline = prvHeapPop( xQueue, pvBuffer );
+			xExpired = DEADLINE_BEFORE( xDeadline, xTaskGetTickCount() );
+
+			if( xExpired != pdFALSE )
+			{
+				xQueue->ulExpiredCount++;
+			}
+		}
+		taskEXIT_CRITICAL();
+
+		( void ) xSemaphoreGive( xQueue->xSpaces );
+
+		if( ( xExpired == pdFALSE ) || ( xQueue->xExpiredPolicy != DEADLINE_QUEUE_DROP_EXPIRED ) )
+		{
+			break;
+		}
+
+		// Dropped, wait for the next item with what is left of the timeout
+		if( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) != pdFALSE )
+		{
+			return errQUEUE_EMPTY;
+		}
+	}
+
+	if( pxDeadline != NULL )
+	{
+		*pxDeadline = xDeadline;
+	}
+
+	return pdPASS;
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxDeadlineQueueReceiveBatch( DeadlineQueueHandle_t xQueue,
+                                         void * pvBuffer,
+                                         TickType_t * pxDeadlines,
+                                         UBaseType_t uxMaxItems,
+                                         TickType_t xTicksToWait )
+{
+	TimeOut_t xTimeOut;
+	TickType_t xDeadline, xNow;
+	UBaseType_t uxTaken, uxIndex, uxCount;
+	uint8_t *pucBuffer = ( uint8_t * ) pvBuffer;
+
+	configASSERT( uxMaxItems > 0 );
+
+	vTaskSetTimeOutState( &xTimeOut );
+
+	for( ;; )
+	{
+		if( xSemaphoreTake( xQueue->xItems, xTicksToWait ) != pdTRUE )
+		{
+			return 0;
+		}
+
+		// Claim whatever else is already waiting, without blocking
+		for( uxTaken = 1; uxTaken < uxMaxItems; uxTaken++ )
+		{
+			if( xSemaphoreTake( xQueue->xItems, 0 ) != pdTRUE )
+			{
+				break;
+			}
+		}
+
+		uxCount = 0;
+
+		taskENTER_CRITICAL();
+		{
+			xNow = xTaskGetTickCount();
+
+			for( uxIndex = 0; uxIndex < uxTaken; uxIndex++ )
+			{
+				xDeadline = prvHeapPop( xQueue, &pucBuffer[ uxCount * xQueue->uxItemSize ] );
+
+				if( DEADLINE_BEFORE( xDeadline, xNow ) )
+				{
+					xQueue->ulExpiredCount++;
+
+					// Dropped, the next item overwrites it
+					if( xQueue->xExpiredPolicy == DEADLINE_QUEUE_DROP_EXPIRED )
+					{
+						continue;
+					}
+				}
+
+				if( pxDeadlines != NULL )
+				{
+					pxDeadlines[ uxCount ] = xDeadline;
+				}
+
+				uxCount++;
+			}
+		}
+		taskEXIT_CRITICAL();
+
+		for( uxIndex = 0; uxIndex < uxTaken; uxIndex++ )
+		{
+			( void ) xSemaphoreGive( xQueue->xSpaces );
+		}
+
+		if( uxCount > 0 )
+		{
+			return uxCount;
+		}
+
+		// All dropped, wait for the next item with what is left of the timeout
+		if( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) != pdFALSE )
+		{
+			return 0;
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+uint32_t ulDeadlineQueueGetExpiredCount( DeadlineQueueHandle_t xQueue )
+{
+	return xQueue->ulExpiredCount;
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxDeadlineQueueMessagesWaiting( DeadlineQueueHandle_t xQueue )
+{
+	UBaseType_t uxCount;
+
+	taskENTER_CRITICAL();
+	{
+		uxCount = xQueue->uxCount;
+	}
+	taskEXIT_CRITICAL();
+
+	return uxCount;
+}
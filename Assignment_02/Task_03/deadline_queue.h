@@ -0,0 +1,79 @@
+/*
+ * Deadline-stamped message queue.
+ *
+ * Every item is sent with a relative deadline and the receiver always gets the
+ * item whose absolute deadline is the earliest, whatever the order in which
+ * the items were sent.  The items are kept in a bounded binary heap inside the
+ * queue storage, so sending and receiving cost O(log n) copies.
+ *
+ * Items whose deadline passed while they were waiting are counted on the way
+ * out, and dropped if the queue was created with DEADLINE_QUEUE_DROP_EXPIRED.
+ *
+ * Requires configUSE_COUNTING_SEMAPHORES set to 1 in FreeRTOSConfig.h.
+ */
+
+#ifndef DEADLINE_QUEUE_H
+#define DEADLINE_QUEUE_H
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+// What happens to an item received after its deadline
+#define DEADLINE_QUEUE_DELIVER_EXPIRED 0
+#define DEADLINE_QUEUE_DROP_EXPIRED 1
+
+// Type definitions
+typedef struct DeadlineQueue_st * DeadlineQueueHandle_t;
+
+/*
+ * Creates a queue of uxLength items of uxItemSize bytes.  Returns NULL if
+ * there is not enough heap.
+ */
+DeadlineQueueHandle_t xDeadlineQueueCreate( UBaseType_t uxLength,
+                                            UBaseType_t uxItemSize,
+                                            BaseType_t xExpiredPolicy );
+
+/*
+ * Copies pvItem into the queue with an absolute deadline of now +
+ * xRelativeDeadline.  Blocks up to xTicksToWait for a free slot, returns
+ * pdPASS or errQUEUE_FULL.
+ */
+BaseType_t xDeadlineQueueSend( DeadlineQueueHandle_t xQueue,
+                               const void * pvItem,
+                               TickType_t xRelativeDeadline,
+                               TickType_t xTicksToWait );
+
+/*
+ * Copies the most urgent item into pvBuffer.  Blocks up to xTicksToWait for
+ * an item, returns pdPASS or errQUEUE_EMPTY.  pxDeadline, if not NULL,
+ * receives the absolute deadline of the item.
+ */
+BaseType_t xDeadlineQueueReceive( DeadlineQueueHandle_t xQueue,
+                                  void * pvBuffer,
+                                  TickType_t * pxDeadline,
+                                  TickType_t xTicksToWait );
+
+/*
+ * Copies up to uxMaxItems of the most urgent items, in deadline order, into
+ * pvBuffer (an array of items) and their deadlines into pxDeadlines if it is
+ * not NULL.  Blocks up to xTicksToWait for the first item only, the others
+ * are whatever is already waiting, taken out of the heap in one critical
+ * section.  Returns the number of items copied, 0 on timeout.
+ */
+UBaseType_t uxDeadlineQueueReceiveBatch( DeadlineQueueHandle_t xQueue,
+                                         void * pvBuffer,
+                                         TickType_t * pxDeadlines,
+                                         UBaseType_t uxMaxItems,
+                                         TickType_t xTicksToWait );
+
+/*
+ * Returns the number of items received (or dropped) after their deadline.
+ */
+uint32_t ulDeadlineQueueGetExpiredCount( DeadlineQueueHandle_t xQueue );
+
+/*
+ * Returns the number of items waiting in the queue.
+ */
+UBaseType_t uxDeadlineQueueMessagesWaiting( DeadlineQueueHandle_t xQueue );
+
+#endif /* DEADLINE_QUEUE_H */
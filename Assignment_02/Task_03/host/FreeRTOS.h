@@ -0,0 +1,30 @@
+/*
+ * Host stand-in for the FreeRTOS.h of the kernel, with just what
+ * ../spsc_ring.c uses, so spsc_bench.c can build the ring unchanged.  The
+ * types have the sizes of the ARM7 port.
+ */
+
+#ifndef FREERTOS_H_HOST
+#define FREERTOS_H_HOST
+
+/* Standard includes. */
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <assert.h>
+
+typedef long BaseType_t;
+typedef unsigned long UBaseType_t;
+typedef uint32_t TickType_t;
+
+#define pdFALSE ( ( BaseType_t ) 0 )
+#define pdTRUE ( ( BaseType_t ) 1 )
+#define pdPASS ( pdTRUE )
+
+#define configASSERT( x ) assert( x )
+#define portMEMORY_BARRIER() __asm volatile ( "" ::: "memory" )
+
+#define pvPortMalloc( xSize ) malloc( xSize )
+#define vPortFree( pv ) free( pv )
+
+#endif /* FREERTOS_H_HOST */
@@ -0,0 +1,253 @@
+/*
+ * Host benchmark of the SPSC ring (see ../spsc_ring.h) against a lock-based
+ * queue.
+ *
+ * ../spsc_ring.c is built unchanged against the stand-in FreeRTOS.h and
+ * task.h of this directory.  The queue model copies one message per call
+ * inside a lock, as xQueueSend() and xQueueReceive() do inside their
+ * critical sections; the lock is a pthread mutex, never contended.
+ *
+ * The producer and the consumer take turns in one thread, as they do on the
+ * single core of the LPC2138: the producer sends a burst, then the consumer
+ * drains it.  The ring is measured with one item per call, like the queue,
+ * and with the whole burst in one call.  Every message carries a sequence
+ * number checked by the consumer.
+ *
+ * The figures are host figures: they compare the two designs, the ratios
+ * and not the rates carry over to the target.
+ *
+ *     gcc -O2 -I. -o spsc_bench spsc_bench.c ../spsc_ring.c -lpthread
+ *     ./spsc_bench
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+
+#include "../spsc_ring.h"
+
+// Messages sent by every run
+#define BENCH_MESSAGES ( 1UL << 24 )
+
+// Slots of the ring and of the queue, a power of two for the ring
+#define BENCH_CAPACITY 64
+
+// Longest burst, at most BENCH_CAPACITY
+#define BENCH_MAX_BURST 32
+
+// Type definitions
+typedef struct
+{
+	uint32_t ulSequence;
+	uint32_t ulStamp;
+} BenchMessage_st;
+
+typedef struct
+{
+	pthread_mutex_t xLock;
+	BenchMessage_st xItems[ BENCH_CAPACITY ];
+	unsigned int uiHead;
+	unsigned int uiTail;
+	unsigned int uiCount;
+} BenchQueue_st;
+
+typedef enum
+{
+	BENCH_RING_SINGLE,
+	BENCH_RING_BATCH,
+	BENCH_QUEUE
+} BenchPath_t;
+
+// Global Variables
+static BenchQueue_st xBenchQueue;
+
+// Prototypes, not inlined so the queue pays for its calls like the ring
+static int prvQueueSend( BenchQueue_st *pxQueue, const BenchMessage_st *pxMessage ) __attribute__( ( noinline ) );
+static int prvQueueReceive( BenchQueue_st *pxQueue, BenchMessage_st *pxMessage ) __attribute__( ( noinline ) );
+
+/*-----------------------------------------------------------*/
+
+static double prvNow( void )
+{
+	struct timespec xTime;
+
+	clock_gettime( CLOCK_MONOTONIC, &xTime );
+
+	return ( double ) xTime.tv_sec + ( ( double ) xTime.tv_nsec * 1e-9 );
+}
+/*-----------------------------------------------------------*/
+
+static int prvQueueSend( BenchQueue_st *pxQueue, const BenchMessage_st *pxMessage )
+{
+	int iSent = 0;
+
+	pthread_mutex_lock( &pxQueue->xLock );
+
+	if( pxQueue->uiCount < BENCH_CAPACITY )
+	{
+		memcpy( &pxQueue->xItems[ pxQueue->uiHead ], pxMessage, sizeof( BenchMessage_st ) );
+		pxQueue->uiHead = ( pxQueue->uiHead + 1 ) % BENCH_CAPACITY;
+		pxQueue->uiCount++;
+		iSent = 1;
+	}
+
+	pthread_mutex_unlock( &pxQueue->xLock );
+
+	return iSent;
+}
+/*-----------------------------------------------------------*/
+
+static int prvQueueReceive( BenchQueue_st *pxQueue, BenchMessage_st *pxMessage )
+{
+	int iReceived = 0;
+
+	pthread_mutex_lock( &pxQueue->xLock );
+
+	if( pxQueue->uiCount > 0 )
+	{
+		memcpy( pxMessage, &pxQueue->xItems[ pxQueue->uiTail ], sizeof( BenchMessage_st ) );
+		pxQueue->uiTail = ( pxQueue->uiTail + 1 ) % BENCH_CAPACITY;
+		pxQueue->uiCount--;
+		iReceived = 1;
+	}
+
+	pthread_mutex_unlock( &pxQueue->xLock );
+
+	return iReceived;
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * Sends BENCH_MESSAGES messages in bursts of uiBurst through one path and
+ * returns the rate in messages per second, or a negative value if a message
+ * is lost or out of order.
+ */
+static double prvRun( BenchPath_t xPath, SpscRingHandle_t xRing, unsigned int uiBurst )
+{
+	BenchMessage_st xOut[ BENCH_MAX_BURST ], xIn[ BENCH_MAX_BURST ];
+	uint32_t ulSent = 0, ulReceived = 0;
+	unsigned int uiIndex, uiCount;
+	double dStart;
+
+	dStart = prvNow();
+
+	while( ulSent < BENCH_MESSAGES )
+	{
+		for( uiIndex = 0; uiIndex < uiBurst; uiIndex++ )
+		{
+			xOut[ uiIndex ].ulSequence = ulSent + uiIndex;
+			xOut[ uiIndex ].ulStamp = ulSent;
+		}
+
+		// Producer turn
+		switch( xPath )
+		{
+			case BENCH_RING_SINGLE:
+				for( uiIndex = 0; uiIndex < uiBurst; uiIndex++ )
+				{
+					uiCount = ( unsigned int ) uxSpscRingPush( xRing, &xOut[ uiIndex ], 1 );
+
+					if( uiCount != 1 )
+					{
+						break;
+					}
+				}
+
+				uiCount = uiIndex;
+				break;
+
+			case BENCH_RING_BATCH:
+				uiCount = ( unsigned int ) uxSpscRingPush( xRing, xOut, uiBurst );
+				break;
+
+			default:
+				for( uiIndex = 0; ( uiIndex < uiBurst ) && prvQueueSend( &xBenchQueue, &xOut[ uiIndex ] ); uiIndex++ )
+				{
+				}
+
+				uiCount = uiIndex;
+				break;
+		}
+
+		ulSent += uiCount;
+
+		// Consumer turn
+		switch( xPath )
+		{
+			case BENCH_RING_SINGLE:
+				for( uiCount = 0; uxSpscRingPop( xRing, &xIn[ uiCount ], 1 ) == 1; uiCount++ )
+				{
+				}
+
+				break;
+
+			case BENCH_RING_BATCH:
+				uiCount = ( unsigned int ) uxSpscRingPop( xRing, xIn, BENCH_MAX_BURST );
+				break;
+
+			default:
+				for( uiCount = 0; prvQueueReceive( &xBenchQueue, &xIn[ uiCount ] ); uiCount++ )
+				{
+				}
+
+				break;
+		}
+
+		for( uiIndex = 0; uiIndex < uiCount; uiIndex++ )
+		{
+			if( xIn[ uiIndex ].ulSequence != ulReceived++ )
+			{
+				return -1.0;
+			}
+		}
+	}
+
+	if( ulReceived != BENCH_MESSAGES )
+	{
+		return -1.0;
+	}
+
+	return ( double ) BENCH_MESSAGES / ( prvNow() - dStart );
+}
+/*-----------------------------------------------------------*/
+
+int main( void )
+{
+	static const unsigned int uiBursts[] = { 1, 4, 16, 32 };
+	double dRates[ 3 ];
+	SpscRingHandle_t xRing;
+	unsigned int uiBurst, uiPath;
+
+	xRing = xSpscRingCreate( BENCH_CAPACITY, sizeof( BenchMessage_st ) );
+
+	if( xRing == NULL )
+	{
+		fprintf( stderr, "no memory for the ring\n" );
+		return 1;
+	}
+
+	pthread_mutex_init( &xBenchQueue.xLock, NULL );
+
+	printf( "%u-byte messages, %lu per run, %u slots\n", ( unsigned int ) sizeof( BenchMessage_st ), BENCH_MESSAGES, BENCH_CAPACITY );
+	printf( "burst  ring 1 per call  ring batched  locked queue  (M messages/s)\n" );
+
+	for( uiBurst = 0; uiBurst < sizeof( uiBursts ) / sizeof( uiBursts[ 0 ] ); uiBurst++ )
+	{
+		for( uiPath = 0; uiPath < 3; uiPath++ )
+		{
+			dRates[ uiPath ] = prvRun( ( BenchPath_t ) uiPath, xRing, uiBursts[ uiBurst ] );
+
+			if( dRates[ uiPath ] < 0.0 )
+			{
+				fprintf( stderr, "message lost or out of order, path %u, burst %u\n", uiPath, uiBursts[ uiBurst ] );
+				return 1;
+			}
+		}
+
+		printf( "%5u  %15.1f  %12.1f  %12.1f\n", uiBursts[ uiBurst ], dRates[ 0 ] * 1e-6, dRates[ 1 ] * 1e-6, dRates[ 2 ] * 1e-6 );
+	}
+
+	return 0;
+}
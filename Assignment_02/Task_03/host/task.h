@@ -0,0 +1,26 @@
+/*
+ * Host stand-in for the task.h of the kernel, see FreeRTOS.h in this
+ * directory.  The benchmark sets no consumer task, so the notifications are
+ * never sent and a receive does not block.
+ */
+
+#ifndef TASK_H_HOST
+#define TASK_H_HOST
+
+#include "FreeRTOS.h"
+
+typedef void * TaskHandle_t;
+
+typedef struct
+{
+	BaseType_t xOverflowCount;
+	TickType_t xTimeOnEntering;
+} TimeOut_t;
+
+#define xTaskNotifyGive( xTask ) ( ( void ) ( xTask ), pdPASS )
+#define vTaskNotifyGiveFromISR( xTask, pxWoken ) ( ( void ) ( xTask ), ( void ) ( pxWoken ) )
+#define ulTaskNotifyTake( xClear, xTicks ) ( ( void ) ( xClear ), ( void ) ( xTicks ), 0UL )
+#define vTaskSetTimeOutState( pxTimeOut ) ( ( void ) ( pxTimeOut ) )
+#define xTaskCheckForTimeOut( pxTimeOut, pxTicks ) ( ( void ) ( pxTimeOut ), ( void ) ( pxTicks ), pdTRUE )
+
+#endif /* TASK_H_HOST */
@@ -68,6 +68,9 @@
 
 // More Application includes
 #include "queue.h"
+#include "deadline_queue.h"
+#include "block_pool.h"
+#include "input_service.h"
 
 
 
@@ -85,6 +88,19 @@
 // Max Queue size
 #define MESSAGE_QUEUE_LEN 10
 
+// Message blocks: a full queue and one block per producer being filled
+#define MESSAGE_POOL_LEN (MESSAGE_QUEUE_LEN + 3)
+
+// Messages printed per consumer wakeup, in a single UART write
+#define MESSAGE_BATCH_LEN MESSAGE_QUEUE_LEN
+
+// Debounced button edges waiting for each button task
+#define BUTTON_EVENT_QUEUE_LEN 4
+
+// Relative deadlines of the messages in ticks, the earliest one is printed first
+#define BUTTON_MESSAGE_DEADLINE 10
+#define STRING_MESSAGE_DEADLINE 100
+
 
 // Type definitions
 typedef struct
@@ -100,7 +116,13 @@ TaskHandle_t Button1_task_handle = NULL, Button2_task_handle = NULL;
 TaskHandle_t String_task_handle = NULL, Consumer_task_handle = NULL;
 
 // Queue Handlers
-QueueHandle_t message_queue;
+DeadlineQueueHandle_t message_queue;
+
+// Message blocks, owned by the producer until sent and by the consumer after
+BlockPoolHandle_t message_pool;
+
+// Button edges from the input service
+QueueHandle_t button1_events, button2_events;
 
 /*
  * Configure the processor for use with the Keil demo board.  This is very
@@ -123,21 +145,27 @@ void Consumer_task_code(void *);
  */
 int main( void )
 {
-	// Messages
-	Message_st button1_message, button2_message, string_message;
-	
 	/* Setup the hardware for use with the Keil demo board. */
 	prvSetupHardware();
 	
-	// Create Message Queue
-	message_queue = xQueueCreate(MESSAGE_QUEUE_LEN, sizeof(Message_st *));
+	// Create Message Queue, late messages are still printed and counted
+	message_queue = xDeadlineQueueCreate(MESSAGE_QUEUE_LEN, sizeof(Message_st *), DEADLINE_QUEUE_DELIVER_EXPIRED);
+	
+	// Create Message Pool
+	message_pool = xBlockPoolCreate(MESSAGE_POOL_LEN, sizeof(Message_st));
+	
+	// Subscribe the button tasks to their pins, sampled from the tick hook
+	button1_events = xQueueCreate(BUTTON_EVENT_QUEUE_LEN, sizeof(InputEvent_st));
+	button2_events = xQueueCreate(BUTTON_EVENT_QUEUE_LEN, sizeof(InputEvent_st));
+	xInputServiceSubscribe(PORT_0, PIN0, 1, button1_events);
+	xInputServiceSubscribe(PORT_0, PIN1, 2, button2_events);
 	
 	/* Create Tasks here */
 	// Button 1 Task
 	xTaskCreate(Button1_task_code, // Function that implements the task.
               "Button1 Task", // Text name for the task.
               100, // Stack size in words, not bytes.
-              (void *) &button1_message, // Parameter passed into the task.
+              (void *) NULL, // Parameter passed into the task.
               1, // Priority at which the task is created.
               &Button1_task_handle ); // Used to pass out the created task's handle.
 	
@@ -145,7 +173,7 @@ int main( void )
 	xTaskCreate(Button2_task_code, // Function that implements the task.
               "Button2 Task", // Text name for the task.
               100, // Stack size in words, not bytes.
-              (void *) &button2_message, // Parameter passed into the task.
+              (void *) NULL, // Parameter passed into the task.
               1, // Priority at which the task is created.
               &Button2_task_handle ); // Used to pass out the created task's handle.
 	
@@ -153,7 +181,7 @@ int main( void )
 	xTaskCreate(String_task_code, // Function that implements the task.
               "String Task", // Text name for the task.
               100, // Stack size in words, not bytes.
-              (void *) &string_message, // Parameter passed into the task.
+              (void *) NULL, // Parameter passed into the task.
               1, // Priority at which the task is created.
               &String_task_handle ); // Used to pass out the created task's handle.
 							
@@ -197,113 +225,105 @@ static void prvSetupHardware( void )
 }
 /*-----------------------------------------------------------*/
 
-void Button1_task_code(void *task_message)
+void Button1_task_code(void *task_parameters)
 {
 	// Task Message
-	Message_st *button1_message_ptr = (Message_st *)task_message;
+	Message_st *button1_message_ptr;
 	
-	// Button States
-	pinState_t button1_prev_state = GPIO_read(PORT_0, PIN0);
-	pinState_t button1_curr_state = button1_prev_state;
+	// Debounced edge
+	InputEvent_st button1_event;
 	
 	while(1)
 	{
-		// Read pin state
-		button1_curr_state = GPIO_read(PORT_0, PIN0);
+		// Sleep until the input service reports an edge
+		xQueueReceive(button1_events, &button1_event, portMAX_DELAY);
+		
+		// Take a fresh block, the consumer owns the previous one
+		button1_message_ptr = (Message_st *) pvBlockPoolAlloc(message_pool);
 		
-		// Detect state transition (rising/falling edge detection)
-		if(button1_curr_state != button1_prev_state)
+		// Pool exhausted: the edge is dropped and counted by the pool
+		if(button1_message_ptr != NULL)
 		{
-			if(button1_curr_state == PIN_IS_HIGH) // prev is LOW -> rising edge
+			if(button1_event.xState == PIN_IS_HIGH) // rising edge
 			{
 				// Add message body to the packet
 				strcpy(button1_message_ptr->message, "Button1 Rising Edge\n");
-				
-				// Add message length to the packet
-				button1_message_ptr->message_len = (uint8_t) strlen(button1_message_ptr->message);
 			}
-			else // prev is HIGH, curr is LOW -> falling edge
+			else // falling edge
 			{
 				// Add message body to the packet
 				strcpy(button1_message_ptr->message, "Button1 Falling Edge\n");
-				
-				// Add message length to the packet
-				button1_message_ptr->message_len = (uint8_t) strlen(button1_message_ptr->message);
 			}
 			
+			// Add message length to the packet
+			button1_message_ptr->message_len = (uint8_t) strlen(button1_message_ptr->message);
+			
 			// Send message to queue
-			xQueueSend(message_queue, (void *) &button1_message_ptr, portMAX_DELAY);
+			xDeadlineQueueSend(message_queue, (void *) &button1_message_ptr, BUTTON_MESSAGE_DEADLINE, portMAX_DELAY);
 		}
-		
-		// Save current state
-		button1_prev_state = button1_curr_state;
-		
-		// Run every 1 ms
-		vTaskDelay(1);
 	}
 }
 
-void Button2_task_code(void *task_message)
+void Button2_task_code(void *task_parameters)
 {
 	// Task Message
-	Message_st *button2_message_ptr = (Message_st *)task_message;
+	Message_st *button2_message_ptr;
 	
-	// Button States
-	pinState_t button2_prev_state = GPIO_read(PORT_0, PIN1);
-	pinState_t button2_curr_state = button2_prev_state;
+	// Debounced edge
+	InputEvent_st button2_event;
 	
 	while(1)
 	{
-		// Read pin state
-		button2_curr_state = GPIO_read(PORT_0, PIN1);
+		// Sleep until the input service reports an edge
+		xQueueReceive(button2_events, &button2_event, portMAX_DELAY);
+		
+		// Take a fresh block, the consumer owns the previous one
+		button2_message_ptr = (Message_st *) pvBlockPoolAlloc(message_pool);
 		
-		// Detect state transition (rising/falling edge detection)
-		if(button2_curr_state != button2_prev_state)
+		// Pool exhausted: the edge is dropped and counted by the pool
+		if(button2_message_ptr != NULL)
 		{
-			if(button2_curr_state == PIN_IS_HIGH) // prev is LOW -> rising edge
+			if(button2_event.xState == PIN_IS_HIGH) // rising edge
 			{
 				// Add message body to the packet
 				strcpy(button2_message_ptr->message, "Button2 Rising Edge\n");
-				
-				// Add message length to the packet
-				button2_message_ptr->message_len = strlen(button2_message_ptr->message);
 			}
-			else // prev is HIGH, curr is LOW -> falling edge
+			else // falling edge
 			{
 				// Add message body to the packet
 				strcpy(button2_message_ptr->message, "Button2 Falling Edge\n");
-				
-				// Add message length to the packet
-				button2_message_ptr->message_len = strlen(button2_message_ptr->message);
 			}
 			
+			// Add message length to the packet
+			button2_message_ptr->message_len = (uint8_t) strlen(button2_message_ptr->message);
+			
 			// Send message to queue
-			xQueueSend(message_queue, (void *) &button2_message_ptr, portMAX_DELAY);
+			xDeadlineQueueSend(message_queue, (void *) &button2_message_ptr, BUTTON_MESSAGE_DEADLINE, portMAX_DELAY);
 		}
-		
-		// Save current state
-		button2_prev_state = button2_curr_state;
-		
-		// Run every 1 ms
-		vTaskDelay(1);
 	}
 }
 
-void String_task_code(void *task_message)
+void String_task_code(void *task_parameters)
 {
 	// Task Message
-	Message_st *string_message_ptr = (Message_st *)task_message;
-	
-	// Add message body to the packet
-	strcpy(string_message_ptr->message, "Periodic Message\n");
-	
-	// Add message length to the packet
-	string_message_ptr->message_len = (uint8_t) strlen(string_message_ptr->message);
+	Message_st *string_message_ptr;
 	
 	while(1)
 	{
-		// Send message to queue
-		xQueueSend(message_queue, (void *) &string_message_ptr, portMAX_DELAY);
+		// Take a fresh block, the consumer owns the previous one
+		string_message_ptr = (Message_st *) pvBlockPoolAlloc(message_pool);
+		
+		if(string_message_ptr != NULL)
+		{
+			// Add message body to the packet
+			strcpy(string_message_ptr->message, "Periodic Message\n");
+			
+			// Add message length to the packet
+			string_message_ptr->message_len = (uint8_t) strlen(string_message_ptr->message);
+			
+			// Send message to queue
+			xDeadlineQueueSend(message_queue, (void *) &string_message_ptr, STRING_MESSAGE_DEADLINE, portMAX_DELAY);
+		}
 		
 		// Run every 100 ms
 		vTaskDelay(100);
@@ -312,19 +332,41 @@ void String_task_code(void *task_message)
 
 void Consumer_task_code(void *task_parameters)
 {
-	// Task Message
-	Message_st *consumer_message_ptr;
+	// Task Messages
+	Message_st *consumer_message_ptrs[MESSAGE_BATCH_LEN];
+	UBaseType_t message_count, message_index;
+	
+	// Messages of one wakeup, the UART reads it until the next wakeup
+	static char burst[MESSAGE_BATCH_LEN * MESSAGE_LEN];
+	unsigned short burst_len;
 	
 	while(1)
 	{
-		// Receive message from queue
-		xQueueReceive(message_queue, (void *) &consumer_message_ptr, portMAX_DELAY);
+		// Receive every waiting message, most urgent first
+		message_count = uxDeadlineQueueReceiveBatch(message_queue, (void *) consumer_message_ptrs, NULL, MESSAGE_BATCH_LEN, portMAX_DELAY);
+		
+		// Join them and give the blocks back
+		burst_len = 0;
+		
+		for(message_index = 0; message_index < message_count; message_index++)
+		{
+			memcpy(&burst[burst_len], consumer_message_ptrs[message_index]->message, consumer_message_ptrs[message_index]->message_len);
+			burst_len += consumer_message_ptrs[message_index]->message_len;
 			
-		// Printing message
-		vSerialPutString((const signed char *)consumer_message_ptr->message, consumer_message_ptr->message_len);
+			vBlockPoolFree(message_pool, consumer_message_ptrs[message_index]);
+		}
+		
+		// Printing messages
+		vSerialPutString((const signed char *)burst, burst_len);
 		
 		// Run every 50 ms
 		vTaskDelay(50);
 	}
 }
+/*-----------------------------------------------------------*/
 
+void vApplicationTickHook(void)
+{
+	// Button sampling and debouncing
+	vInputServiceScanFromISR();
+}
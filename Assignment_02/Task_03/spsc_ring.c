@@ -0,0 +1,243 @@
+/*
+ * Single-producer, single-consumer ring buffer, see spsc_ring.h.
+ */
+
+/* Standard includes. */
+#include <string.h>
+
+/* Scheduler includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "spsc_ring.h"
+
+// Keeps the item copies on their side of the index updates.  The ARM7 is
+// single-core and in-order, only the compiler has to be held back.
+#if defined( __CC_ARM )
+#define SPSC_BARRIER() __memory_changed()
+#elif defined( __GNUC__ )
+#define SPSC_BARRIER() __asm volatile ( "" ::: "memory" )
+#else
+#define SPSC_BARRIER() portMEMORY_BARRIER()
+#endif
+
+// Type definitions
+typedef union
+{
+	volatile UBaseType_t uxValue;
+	uint8_t ucLine[ SPSC_RING_LINE_SIZE ];
+} SpscIndex_u;
+
+typedef struct SpscRing_st
+{
+	SpscIndex_u xHead; // Items pushed since creation, written by the producer only
+	SpscIndex_u xTail; // Items popped since creation, written by the consumer only
+	uint8_t *pucItems;
+	size_t xItemSize;
+	UBaseType_t uxMask; // Capacity - 1
+	TaskHandle_t xConsumer;
+} SpscRing_st;
+
+// Prototypes
+static UBaseType_t prvSpscRingCopyIn( SpscRing_st *pxRing, const void *pvItems, UBaseType_t uxCount, BaseType_t *pxWasEmpty );
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Copies the items behind the head and only then publishes the new head, so
+ * the consumer never sees a slot before its data.
+ */
+static UBaseType_t prvSpscRingCopyIn( SpscRing_st *pxRing, const void *pvItems, UBaseType_t uxCount, BaseType_t *pxWasEmpty )
+{
+	UBaseType_t uxHead = pxRing->xHead.uxValue;
+	UBaseType_t uxTail = pxRing->xTail.uxValue;
+	UBaseType_t uxFree = ( pxRing->uxMask + 1 ) - ( uxHead - uxTail );
+	UBaseType_t uxFirst, uxOffset;
+
+	*pxWasEmpty = pdFALSE;
+
+	if( uxCount > uxFree )
+	{
+		uxCount = uxFree;
+	}
+
+	if( uxCount == 0 )
+	{
+		return 0;
+	}
+
+	// Up to the end of the storage, then the rest from the start
+	uxOffset = uxHead & pxRing->uxMask;
+	uxFirst = ( pxRing->uxMask + 1 ) - uxOffset;
+
+	if( uxFirst > uxCount )
+	{
+		uxFirst = uxCount;
+	}
+
+	memcpy( &pxRing->pucItems[ uxOffset * pxRing->xItemSize ], pvItems, uxFirst * pxRing->xItemSize );
+	memcpy( pxRing->pucItems, ( const uint8_t * ) pvItems + ( uxFirst * pxRing->xItemSize ), ( uxCount - uxFirst ) * pxRing->xItemSize );
+
+	SPSC_BARRIER();
+	pxRing->xHead.uxValue = uxHead + uxCount;
+	SPSC_BARRIER();
+
+	// Read the tail again after publishing: if the consumer emptied the ring
+	// meanwhile it will find the new items itself, otherwise it may be waiting
+	if( pxRing->xTail.uxValue == uxHead )
+	{
+		*pxWasEmpty = pdTRUE;
+	}
+
+	return uxCount;
+}
+/*-----------------------------------------------------------*/
+
+SpscRingHandle_t xSpscRingCreate( UBaseType_t uxCapacity,
+                                  size_t xItemSize )
+{
+	SpscRing_st *pxRing;
+
+	// Power of two, so the free-running indices can be masked
+	configASSERT( ( uxCapacity > 0 ) && ( ( uxCapacity & ( uxCapacity - 1 ) ) == 0 ) );
+	configASSERT( xItemSize > 0 );
+
+	pxRing = ( SpscRing_st * ) pvPortMalloc( sizeof( SpscRing_st ) );
+
+	if( pxRing == NULL )
+	{
+		return NULL;
+	}
+
+	pxRing->pucItems = ( uint8_t * ) pvPortMalloc( uxCapacity * xItemSize );
+
+	if( pxRing->pucItems == NULL )
+	{
+		vPortFree( pxRing );
+		return NULL;
+	}
+
+	pxRing->xHead.uxValue = 0;
+	pxRing->xTail.uxValue = 0;
+	pxRing->xItemSize = xItemSize;
+	pxRing->uxMask = uxCapacity - 1;
+	pxRing->xConsumer = NULL;
+
+	return pxRing;
+}
+/*-----------------------------------------------------------*/
+
+void vSpscRingSetConsumer( SpscRingHandle_t xRing,
+                           TaskHandle_t xConsumer )
+{
+	xRing->xConsumer = xConsumer;
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxSpscRingPush( SpscRingHandle_t xRing,
+                            const void * pvItems,
+                            UBaseType_t uxCount )
+{
+	BaseType_t xWasEmpty;
+
+	uxCount = prvSpscRingCopyIn( xRing, pvItems, uxCount, &xWasEmpty );
+
+	if( ( xWasEmpty != pdFALSE ) && ( xRing->xConsumer != NULL ) )
+	{
+		( void ) xTaskNotifyGive( xRing->xConsumer );
+	}
+
+	return uxCount;
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxSpscRingPushFromISR( SpscRingHandle_t xRing,
+                                   const void * pvItems,
+                                   UBaseType_t uxCount,
+                                   BaseType_t * pxHigherPriorityTaskWoken )
+{
+	BaseType_t xWasEmpty;
+
+	uxCount = prvSpscRingCopyIn( xRing, pvItems, uxCount, &xWasEmpty );
+
+	if( ( xWasEmpty != pdFALSE ) && ( xRing->xConsumer != NULL ) )
+	{
+		vTaskNotifyGiveFromISR( xRing->xConsumer, pxHigherPriorityTaskWoken );
+	}
+
+	return uxCount;
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxSpscRingPop( SpscRingHandle_t xRing,
+                           void * pvItems,
+                           UBaseType_t uxMaxCount )
+{
+	UBaseType_t uxTail = xRing->xTail.uxValue;
+	UBaseType_t uxCount = xRing->xHead.uxValue - uxTail;
+	UBaseType_t uxFirst, uxOffset;
+
+	if( uxCount > uxMaxCount )
+	{
+		uxCount = uxMaxCount;
+	}
+
+	if( uxCount == 0 )
+	{
+		return 0;
+	}
+
+	// The head was read before the copies, the slots below it are complete
+	SPSC_BARRIER();
+
+	uxOffset = uxTail & xRing->uxMask;
+	uxFirst = ( xRing->uxMask + 1 ) - uxOffset;
+
+	if( uxFirst > uxCount )
+	{
+		uxFirst = uxCount;
+	}
+
+	memcpy( pvItems, &xRing->pucItems[ uxOffset * xRing->xItemSize ], uxFirst * xRing->xItemSize );
+	memcpy( ( uint8_t * ) pvItems + ( uxFirst * xRing->xItemSize ), xRing->pucItems, ( uxCount - uxFirst ) * xRing->xItemSize );
+
+	// Only hand the slots back once they have been read
+	SPSC_BARRIER();
+	xRing->xTail.uxValue = uxTail + uxCount;
+
+	return uxCount;
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxSpscRingReceive( SpscRingHandle_t xRing,
+                               void * pvItems,
+                               UBaseType_t uxMaxCount,
+                               TickType_t xTicksToWait )
+{
+	UBaseType_t uxCount;
+	TimeOut_t xTimeOut;
+
+	configASSERT( ( xTicksToWait == 0 ) || ( xRing->xConsumer != NULL ) );
+
+	vTaskSetTimeOutState( &xTimeOut );
+
+	for( ;; )
+	{
+		uxCount = uxSpscRingPop( xRing, pvItems, uxMaxCount );
+
+		if( ( uxCount != 0 ) || ( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) != pdFALSE ) )
+		{
+			return uxCount;
+		}
+
+		// A push that found the ring empty leaves a notification pending, so
+		// one made between the pop above and this call is not lost
+		( void ) ulTaskNotifyTake( pdTRUE, xTicksToWait );
+	}
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxSpscRingGetCount( SpscRingHandle_t xRing )
+{
+	return xRing->xHead.uxValue - xRing->xTail.uxValue;
+}
@@ -0,0 +1,84 @@
+/*
+ * Single-producer, single-consumer ring buffer.
+ *
+ * One task or interrupt pushes, one task pops, and neither side ever takes a
+ * lock: the producer only writes the head index, the consumer only writes the
+ * tail index, and each side reads the other's index to know how much room or
+ * data there is.  Both indices run freely and are masked on access, so the
+ * capacity must be a power of two and a full ring holds all of its slots.
+ *
+ * Items are copied in and out in batches of up to two memcpy() calls (one on
+ * each side of the wrap).  Optionally the consumer task is notified when the
+ * ring goes from empty to non-empty, see vSpscRingSetConsumer().
+ *
+ * Calling the push or pop functions from more than one context at a time on
+ * the same side breaks the ring, use a queue for those paths.
+ */
+
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+// Bytes between the head and the tail index.  The LPC21xx has no data cache,
+// so by default the indices are only kept in separate words; raise it to the
+// cache line size on a cached core to stop the two sides sharing a line.
+#ifndef SPSC_RING_LINE_SIZE
+#define SPSC_RING_LINE_SIZE sizeof( UBaseType_t )
+#endif
+
+// Type definitions
+typedef struct SpscRing_st * SpscRingHandle_t;
+
+/*
+ * Creates a ring of uxCapacity items of xItemSize bytes, uxCapacity must be a
+ * power of two.  Returns NULL if there is not enough heap.
+ */
+SpscRingHandle_t xSpscRingCreate( UBaseType_t uxCapacity,
+                                  size_t xItemSize );
+
+/*
+ * Task notified (xTaskNotifyGive) each time the producer finds the ring empty
+ * before a push.  NULL, the default, disables the notification.  The consumer
+ * uses its default notification index, so it must not use it for anything
+ * else while it receives with a timeout.
+ */
+void vSpscRingSetConsumer( SpscRingHandle_t xRing,
+                           TaskHandle_t xConsumer );
+
+/*
+ * Producer side: copies up to uxCount items from pvItems and returns the
+ * number actually pushed, lower than uxCount when the ring fills up.
+ */
+UBaseType_t uxSpscRingPush( SpscRingHandle_t xRing,
+                            const void * pvItems,
+                            UBaseType_t uxCount );
+UBaseType_t uxSpscRingPushFromISR( SpscRingHandle_t xRing,
+                                   const void * pvItems,
+                                   UBaseType_t uxCount,
+                                   BaseType_t * pxHigherPriorityTaskWoken );
+
+/*
+ * Consumer side: copies up to uxMaxCount items into pvItems and returns the
+ * number popped, 0 if the ring is empty.
+ */
+UBaseType_t uxSpscRingPop( SpscRingHandle_t xRing,
+                           void * pvItems,
+                           UBaseType_t uxMaxCount );
+
+/*
+ * As uxSpscRingPop(), but blocks for up to xTicksToWait while the ring is
+ * empty.  Needs the consumer task set with vSpscRingSetConsumer().
+ */
+UBaseType_t uxSpscRingReceive( SpscRingHandle_t xRing,
+                               void * pvItems,
+                               UBaseType_t uxMaxCount,
+                               TickType_t xTicksToWait );
+
+/*
+ * Items currently in the ring.  Exact from either side, a snapshot otherwise.
+ */
+UBaseType_t uxSpscRingGetCount( SpscRingHandle_t xRing );
+
+#endif /* SPSC_RING_H */
@@ -51,6 +51,7 @@
 #define configMAX_PRIORITIES		( 4 )
 #define configMINIMAL_STACK_SIZE	( ( unsigned short ) 90 )
 #define configTOTAL_HEAP_SIZE		( ( size_t ) 13 * 1024 )
+#define configSUPPORT_STATIC_ALLOCATION	1	/* Static TCBs are EDFStaticTask_t, see edf_task.h. */
 #define configMAX_TASK_NAME_LEN		( 8 )
 #define configUSE_TRACE_FACILITY	0
 #define configUSE_16_BIT_TICKS		0
@@ -77,6 +78,22 @@ to exclude the API function. */
 #define configUSE_APPLICATION_TASK_TAG 1
 #define configUSE_EDF_SCHEDULER 1
 
+// EDF admission control: max number of periodic tasks with a declared capacity
+#define configEDF_MAX_PERIODIC_TASKS 8
+
+// Limited-preemption EDF: non-preemptive regions bounded by a per-task Q
+#define configUSE_EDF_LIMITED_PREEMPTION 0
+
+// Time-triggered EDF: dispatch table over the hyperperiod (lcm(5, 8) = 40 ticks)
+#define configUSE_EDF_TIME_TRIGGERED 0
+#define configEDF_TT_MAX_SLOTS 40
+
+// Stride band: best-effort tasks share the CPU left by EDF in proportion to their tickets
+#define configUSE_EDF_STRIDE_BAND 0
+
+// Hot TCB layout: scheduler fields in the first 64 bytes of the TCB, for cores with a data cache (see host/tcb_layout.c)
+#define configEDF_HOT_TCB_LAYOUT 0
+
 #define START_MACRO do{
 #define END_MACRO }while(0)
 
@@ -84,7 +101,38 @@ to exclude the API function. */
 // Run-time analysis
 extern int taskA_in_time, taskA_out_time, taskA_total_time;
 extern int taskB_in_time, taskB_out_time, taskB_total_time;
-//extern int system_time, CPU_load;
+
+// Load monitor, see load_monitor.h
+void vLoadMonitorIdleIn(void);
+void vLoadMonitorIdleOut(void);
+
+// Kernel overhead accounting, see kernel_stats.h
+#define configUSE_KERNEL_STATS 1
+
+#if (configUSE_KERNEL_STATS == 1)
+void vKernelStatsTickEnter(void);
+void vKernelStatsTickExit(void);
+void vKernelStatsSwitchEnter(void);
+void vKernelStatsSwitchExit(void);
+void vKernelStatsCriticalEnter(uint32_t ulLine);
+void vKernelStatsCriticalExit(void);
+void vKernelStatsHooksEnter(void);
+void vKernelStatsHooksExit(void);
+
+#define traceTASK_INCREMENT_TICK(xTickCount) vKernelStatsTickEnter()
+#define traceTASK_INCREMENT_TICK_EXIT() vKernelStatsTickExit()
+#define traceTASK_SWITCH_CONTEXT_ENTER() vKernelStatsSwitchEnter()
+#define traceTASK_SWITCH_CONTEXT_EXIT() vKernelStatsSwitchExit()
+#define traceTASK_CRITICAL_ENTER(ulLine) vKernelStatsCriticalEnter(ulLine)
+#define traceTASK_CRITICAL_EXIT() vKernelStatsCriticalExit()
+
+// Brackets the trace hooks and the tick hook
+#define STATS_HOOKS_ENTER() vKernelStatsHooksEnter()
+#define STATS_HOOKS_EXIT() vKernelStatsHooksExit()
+#else
+#define STATS_HOOKS_ENTER()
+#define STATS_HOOKS_EXIT()
+#endif
 
 // Task Tags
 #define TASKA_TAG 1
@@ -93,6 +141,11 @@ extern int taskB_in_time, taskB_out_time, taskB_total_time;
 // Trace Hooks
 #define traceTASK_SWITCHED_OUT() 								\
 START_MACRO 													\
+	STATS_HOOKS_ENTER();										\
+	if(pxCurrentTCB == xIdleTaskHandle)							\
+	{															\
+		vLoadMonitorIdleOut();									\
+	}															\
 	if((int)pxCurrentTCB->pxTaskTag == TASKA_TAG) 				\
 	{															\
 		GPIO_write(PORT_0, PIN2, PIN_IS_LOW);					\
@@ -109,10 +162,16 @@ START_MACRO 													\
 	{															\
 		GPIO_write(PORT_0, PIN0, PIN_IS_LOW);					\
 	}															\
+	STATS_HOOKS_EXIT();											\
 END_MACRO
 
 #define traceTASK_SWITCHED_IN() 								\
 START_MACRO 													\
+	STATS_HOOKS_ENTER();										\
+	if(pxCurrentTCB == xIdleTaskHandle)							\
+	{															\
+		vLoadMonitorIdleIn();									\
+	}															\
 	if((int)pxCurrentTCB->pxTaskTag == TASKA_TAG) 				\
 	{															\
 		GPIO_write(PORT_0, PIN2, PIN_IS_HIGH);					\
@@ -127,6 +186,7 @@ START_MACRO 													\
 	{															\
 		GPIO_write(PORT_0, PIN0, PIN_IS_HIGH);					\
 	}															\
+	STATS_HOOKS_EXIT();											\
 END_MACRO
 	
 
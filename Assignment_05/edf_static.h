@@ -0,0 +1,126 @@
+/*
+ * Compile-time schedulability checks for a statically declared task set.
+ *
+ * The task set is an X-macro that calls X once per periodic task:
+ *
+ *   #define TASK_SET(X, a) \
+ *       X(a, period, deadline, capacity, maxNPR) \
+ *       ...
+ *
+ * The a argument is internal to the checks and must be passed through as
+ * is.  EDF_STATIC_CHECK(TASK_SET) fails the build when the set cannot be
+ * scheduled by the EDF kernel:
+ *
+ *  - a task with capacity > deadline or deadline > period,
+ *  - a total utilization (each C/T rounded up like the admission test) above 1,
+ *  - a hyperperiod longer than EDF_STATIC_HORIZON ticks,
+ *  - a deadline t in the horizon where the demand bound function plus
+ *    the longest non-preemptive region of a task with a deadline after t
+ *    exceeds t (limited-preemption EDF, exact for synchronous releases),
+ *  - a deadline t of a task where the densities C/D of the tasks with a
+ *    deadline up to t, plus the longest non-preemptive region of a task with
+ *    a later deadline divided by t, exceed 1.  This is the test the kernel
+ *    runs in prvEDFAdmissionTest(), same rounding.  It is sufficient only, so
+ *    with constrained deadlines it refuses sets the demand bound accepts;
+ *    the build refuses them too, as xTaskPeriodicCreateStatic() would.
+ *
+ * The regions count only with configUSE_EDF_LIMITED_PREEMPTION set to 1,
+ * include FreeRTOS.h first.
+ *
+ * Everything is a constant expression: EDF_HYPERPERIOD(TASK_SET) and
+ * EDF_UTILIZATION(TASK_SET) can be used to size tables or compare against
+ * the run-time figures.
+ */
+
+#ifndef EDF_STATIC_H
+#define EDF_STATIC_H
+
+// Longest hyperperiod the checks can unroll, in ticks
+#define EDF_STATIC_HORIZON 256
+
+// Utilization reached by 100 % of the CPU, same scale as the admission test
+#define EDF_STATIC_UTILIZATION_SCALE 10000UL
+
+// _Static_assert from C11, an array of negative size before
+#if defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201112L)
+#define EDF_STATIC_ASSERT(cond, msg) _Static_assert((cond), msg)
+#else
+#define EDF_STATIC_ASSERT(cond, msg) extern char edf_static_assert[(cond) ? 1 : -1]
+#endif
+
+// Calls M(set, t) for t = 1 .. EDF_STATIC_HORIZON
+#define EDF_REP1(M, set, t) M(set, (t))
+#define EDF_REP2(M, set, t) EDF_REP1(M, set, t) EDF_REP1(M, set, (t) + 1)
+#define EDF_REP4(M, set, t) EDF_REP2(M, set, t) EDF_REP2(M, set, (t) + 2)
+#define EDF_REP8(M, set, t) EDF_REP4(M, set, t) EDF_REP4(M, set, (t) + 4)
+#define EDF_REP16(M, set, t) EDF_REP8(M, set, t) EDF_REP8(M, set, (t) + 8)
+#define EDF_REP32(M, set, t) EDF_REP16(M, set, t) EDF_REP16(M, set, (t) + 16)
+#define EDF_REP64(M, set, t) EDF_REP32(M, set, t) EDF_REP32(M, set, (t) + 32)
+#define EDF_REP128(M, set, t) EDF_REP64(M, set, t) EDF_REP64(M, set, (t) + 64)
+#define EDF_REP256(M, set, t) EDF_REP128(M, set, t) EDF_REP128(M, set, (t) + 128)
+#define EDF_FOR_HORIZON(M, set) EDF_REP256(M, set, 1UL)
+
+// Per task terms, a is the argument passed through the set
+#define EDF_X_PARAMS_OK(a, T, D, C, Q) && ((C) <= (D)) && ((D) <= (T)) && ((T) > 0) && ((Q) <= (C))
+#define EDF_X_UTILIZATION(a, T, D, C, Q) + ((((C) * EDF_STATIC_UTILIZATION_SCALE) + (T) - 1UL) / (T))
+#define EDF_X_DIVIDES(a, T, D, C, Q) && (((a) % (T)) == 0)
+#define EDF_X_DEADLINE_AT(a, T, D, C, Q) || (((a) >= (D)) && ((((a) - (D)) % (T)) == 0))
+#define EDF_X_DEMAND(a, T, D, C, Q) + (((a) >= (D)) ? ((((a) - (D)) / (T)) + 1UL) * (C) : 0UL)
+#define EDF_X_BLOCKING_OK(a, T, D, C, Q) && (((D) <= EDF_ARG_T a) || (EDF_NPR(Q) <= EDF_ARG_SLACK a))
+#define EDF_X_IS_DEADLINE(a, T, D, C, Q) || ((D) == (a))
+#define EDF_X_DENSITY(a, T, D, C, Q) + (((D) <= (a)) ? ((((C) * EDF_STATIC_UTILIZATION_SCALE) + (D) - 1UL) / (D)) : 0UL)
+#define EDF_X_DENSITY_BLOCKING_OK(a, T, D, C, Q) \
+	&& (((D) <= EDF_ARG_T a) || \
+	    ((EDF_ARG_SLACK a + (((EDF_NPR(Q) * EDF_STATIC_UTILIZATION_SCALE) + EDF_ARG_T a - 1UL) / EDF_ARG_T a)) <= EDF_STATIC_UTILIZATION_SCALE))
+
+#define EDF_ARG_T(t, slack) (t)
+#define EDF_ARG_SLACK(t, slack) (slack)
+
+// Regions the kernel honours, none without limited preemption
+#if defined(configUSE_EDF_LIMITED_PREEMPTION) && (configUSE_EDF_LIMITED_PREEMPTION == 1)
+#define EDF_NPR(Q) (Q)
+#else
+#define EDF_NPR(Q) 0UL
+#endif
+
+#define EDF_PARAMS_OK(set) (1 set(EDF_X_PARAMS_OK, 0))
+#define EDF_UTILIZATION(set) (0UL set(EDF_X_UTILIZATION, 0))
+
+// t is a common multiple of the periods
+#define EDF_IS_MULTIPLE(set, t) (1 set(EDF_X_DIVIDES, t))
+
+// Hyperperiod from the multiples of the periods in the horizon: with c of
+// them summing to s, they are H, 2H .. cH and H = 2s / (c (c + 1))
+#define EDF_M_MULTIPLE_COUNT(set, t) + (EDF_IS_MULTIPLE(set, t) ? 1UL : 0UL)
+#define EDF_M_MULTIPLE_SUM(set, t) + (EDF_IS_MULTIPLE(set, t) ? (t) : 0UL)
+#define EDF_MULTIPLE_COUNT(set) (0UL EDF_FOR_HORIZON(EDF_M_MULTIPLE_COUNT, set))
+#define EDF_MULTIPLE_SUM(set) (0UL EDF_FOR_HORIZON(EDF_M_MULTIPLE_SUM, set))
+#define EDF_HYPERPERIOD(set) \
+	((EDF_MULTIPLE_COUNT(set) == 0) ? 0UL : \
+	 ((2UL * EDF_MULTIPLE_SUM(set)) / (EDF_MULTIPLE_COUNT(set) * (EDF_MULTIPLE_COUNT(set) + 1UL))))
+
+// Demand bound function: work of the jobs released and due in [0, t]
+#define EDF_DEMAND(set, t) (0UL set(EDF_X_DEMAND, t))
+
+// Tested at every deadline of the horizon, which covers the hyperperiod
+#define EDF_M_DEMAND_OK(set, t) \
+	&& (!(0 set(EDF_X_DEADLINE_AT, t)) || \
+	    ((EDF_DEMAND(set, t) <= (t)) && (1 set(EDF_X_BLOCKING_OK, ((t), (t) - EDF_DEMAND(set, t))))))
+#define EDF_DEMAND_OK(set) (1 EDF_FOR_HORIZON(EDF_M_DEMAND_OK, set))
+
+// Density test of the admission test at every task deadline t, the slack
+// argument of EDF_X_DENSITY_BLOCKING_OK carries the density up to t
+#define EDF_DENSITY(set, t) (0UL set(EDF_X_DENSITY, t))
+#define EDF_M_DENSITY_OK(set, t) \
+	&& (!(0 set(EDF_X_IS_DEADLINE, t)) || \
+	    ((EDF_DENSITY(set, t) <= EDF_STATIC_UTILIZATION_SCALE) && (1 set(EDF_X_DENSITY_BLOCKING_OK, ((t), EDF_DENSITY(set, t))))))
+#define EDF_DENSITY_OK(set) (1 EDF_FOR_HORIZON(EDF_M_DENSITY_OK, set))
+
+#define EDF_STATIC_CHECK(set) \
+	EDF_STATIC_ASSERT(EDF_PARAMS_OK(set), "EDF task set: a task needs C <= D <= T and Q <= C"); \
+	EDF_STATIC_ASSERT(EDF_UTILIZATION(set) <= EDF_STATIC_UTILIZATION_SCALE, "EDF task set: utilization above 1"); \
+	EDF_STATIC_ASSERT(EDF_HYPERPERIOD(set) > 0, "EDF task set: hyperperiod longer than EDF_STATIC_HORIZON"); \
+	EDF_STATIC_ASSERT(EDF_DEMAND_OK(set), "EDF task set: demand bound exceeded"); \
+	EDF_STATIC_ASSERT(EDF_DENSITY_OK(set), "EDF task set: refused by the admission test")
+
+#endif /* EDF_STATIC_H */
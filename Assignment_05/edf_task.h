@@ -0,0 +1,229 @@
+/*
+ * EDF scheduler API of the tasks.c of this assignment.
+ *
+ * Include this header after task.h in tasks.c and in every file calling the
+ * functions below.  It also sets the defaults of the configEDF_* and
+ * configUSE_EDF_* options left out of FreeRTOSConfig.h, so every file sees
+ * the same configuration as the kernel.
+ *
+ * The task.h of the course kernel this project builds against (it is not in
+ * this tree) declares xTaskPeriodicCreate() with the period only, and the
+ * EDF kernel adds the capacity and the longest non-preemptive region.  C
+ * does not accept two prototypes of one name with different parameters, so
+ * the macro below makes the kernel define the function, and the callers
+ * call it, as xTaskEDFPeriodicCreate().  The source keeps the
+ * xTaskPeriodicCreate() name; the map file and the debugger show the
+ * xTaskEDFPeriodicCreate symbol.  Drop the macro once task.h no longer
+ * declares the old prototype.
+ */
+
+#ifndef EDF_TASK_H
+#define EDF_TASK_H
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+// Default values of the EDF extensions configuration
+#if (configUSE_EDF_SCHEDULER == 1)
+	#ifndef configEDF_MAX_PERIODIC_TASKS
+		#define configEDF_MAX_PERIODIC_TASKS 8
+	#endif
+	#ifndef configUSE_EDF_LIMITED_PREEMPTION
+		#define configUSE_EDF_LIMITED_PREEMPTION 0
+	#endif
+	#ifndef configUSE_EDF_TIME_TRIGGERED
+		#define configUSE_EDF_TIME_TRIGGERED 0
+	#endif
+	#ifndef configEDF_TT_MAX_SLOTS
+		#define configEDF_TT_MAX_SLOTS 64
+	#endif
+	#ifndef configUSE_EDF_STRIDE_BAND
+		#define configUSE_EDF_STRIDE_BAND 0
+	#endif
+	#ifndef configEDF_HOT_TCB_LAYOUT
+		#define configEDF_HOT_TCB_LAYOUT 0
+	#endif
+#else
+	#undef configUSE_EDF_LIMITED_PREEMPTION
+	#define configUSE_EDF_LIMITED_PREEMPTION 0
+	#undef configUSE_EDF_TIME_TRIGGERED
+	#define configUSE_EDF_TIME_TRIGGERED 0
+	#undef configUSE_EDF_STRIDE_BAND
+	#define configUSE_EDF_STRIDE_BAND 0
+	#undef configEDF_HOT_TCB_LAYOUT
+	#define configEDF_HOT_TCB_LAYOUT 0
+#endif
+
+#if (configUSE_EDF_SCHEDULER == 1)
+
+// Returned by the functions below when the task would make the set unschedulable
+#define errEDF_TASK_NOT_SCHEDULABLE ( -6 )
+
+// Link name of xTaskPeriodicCreate(), see the comment at the top of the file
+#define xTaskPeriodicCreate xTaskEDFPeriodicCreate
+
+/*
+ * Buffer of a statically allocated TCB.  StaticTask_t of FreeRTOS.h only
+ * mirrors the stock TCB, the EDF fields of tasks.c need the room added
+ * below.  Use it for the TCB of every static task, the idle task included;
+ * tasks.c fails to build if it gets too small.  xTaskCreateStatic() takes a
+ * StaticTask_t, so it refuses every task under EDF (NULL, and a failed
+ * assert); create static tasks with xTaskPeriodicCreateStatic().
+ */
+#if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+typedef struct
+{
+	StaticTask_t xTask;
+	// Same types in the same order as the TCB, for the same alignment padding
+	#if (configUSE_EDF_STRIDE_BAND == 1)
+	UBaseType_t uxDummy1;
+	TickType_t xDummy2[ 2 ];
+	UBaseType_t uxDummy3;
+	#endif
+	#if (configUSE_EDF_LIMITED_PREEMPTION == 1)
+	TickType_t xDummy4;
+	UBaseType_t uxDummy5;
+	TickType_t xDummy6;
+	#endif
+	TickType_t xDummy7[ 4 ];
+	uint8_t ucDummy8;
+} EDFStaticTask_t;
+#endif
+
+/*
+ * Provided by the application in place of vApplicationGetIdleTaskMemory(),
+ * which hands out a StaticTask_t.  Called by vTaskStartScheduler() to get
+ * the TCB buffer, the stack and the stack depth (in words) of the idle task.
+ */
+#if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+void vApplicationGetEDFIdleTaskMemory( EDFStaticTask_t ** ppxIdleTaskTCBBuffer,
+                                       StackType_t ** ppxIdleTaskStackBuffer,
+                                       uint32_t * pulIdleTaskStackSize );
+#endif
+
+/*
+ * Creates a periodic task with its deadline equal to its period.  capacity
+ * is its worst case execution time in ticks, 0 to skip the admission test,
+ * and maxNPR its longest non-preemptive region (Q), 0 if it is fully
+ * preemptive.  The first job is released now.  Returns pdPASS,
+ * errCOULD_NOT_ALLOCATE_REQUIRED_MEMORY or errEDF_TASK_NOT_SCHEDULABLE, in
+ * which case nothing is created.
+ */
+#if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+BaseType_t xTaskPeriodicCreate( TaskFunction_t pxTaskCode,
+                                const char * const pcName,
+                                const configSTACK_DEPTH_TYPE usStackDepth,
+                                void * const pvParameters,
+                                UBaseType_t uxPriority,
+                                TaskHandle_t * const pxCreatedTask,
+                                TickType_t period,
+                                TickType_t capacity,
+                                TickType_t maxNPR );
+#endif
+
+/*
+ * Same as xTaskPeriodicCreate() with a deadline shorter than the period and
+ * buffers given by the caller.  When the task is rejected *pxCreatedTask is
+ * set to NULL and the buffers can be reused.
+ */
+#if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+BaseType_t xTaskPeriodicCreateStatic( TaskFunction_t pxTaskCode,
+                                      const char * const pcName,
+                                      const uint32_t ulStackDepth,
+                                      void * const pvParameters,
+                                      UBaseType_t uxPriority,
+                                      TaskHandle_t * const pxCreatedTask,
+                                      StackType_t * const puxStackBuffer,
+                                      EDFStaticTask_t * const pxTaskBuffer,
+                                      TickType_t period,
+                                      TickType_t deadline,
+                                      TickType_t capacity,
+                                      TickType_t maxNPR );
+#endif
+
+/*
+ * Changes the timing of a periodic task, NULL for the calling task.  The
+ * new values go through the admission test and take effect at the next job
+ * boundary; the old ones are kept when errEDF_TASK_NOT_SCHEDULABLE is
+ * returned.
+ */
+BaseType_t xTaskPeriodicSetParameters( TaskHandle_t xTask,
+                                       TickType_t period,
+                                       TickType_t deadline,
+                                       TickType_t capacity );
+
+/*
+ * Current period of a task, NULL for the calling task.
+ */
+TickType_t xTaskGetPeriod( TaskHandle_t xTask );
+
+/*
+ * Utilization of the admitted tasks, 10000 for 100 %, each C/T rounded up
+ * like the admission test.
+ */
+uint32_t ulTaskPeriodicGetUtilization( void );
+
+/*
+ * Ends the current job and waits for the next release, one period after
+ * *pxPreviousWakeTime.  The period is read at the end of the job, so a
+ * change made by xTaskPeriodicSetParameters() applies from the next release.
+ */
+#if ( INCLUDE_xTaskDelayUntil == 1 )
+BaseType_t xTaskDelayUntilNextPeriod( TickType_t * const pxPreviousWakeTime );
+#endif
+
+/*
+ * Takes a periodic task out of the admitted set when its current job ends,
+ * and puts it back with a fresh release.  Activation returns
+ * errEDF_TASK_NOT_SCHEDULABLE if the task no longer fits.
+ */
+#if ( INCLUDE_vTaskSuspend == 1 )
+void vTaskPeriodicDeactivate( TaskHandle_t xTask );
+BaseType_t xTaskPeriodicActivate( TaskHandle_t xTask );
+#endif
+
+/*
+ * Time-triggered dispatch: builds the table of one hyperperiod from the
+ * admitted tasks, or takes one built offline (a task handle per tick, NULL
+ * for an idle slot).  The kernel falls back to online EDF when a job
+ * overruns its slots; xTaskTimeTriggeredIsActive() tells which one runs.
+ * A non-preemptive region is not cut short by a slot boundary, so a table
+ * used with limited preemption has to leave room for the regions.
+ */
+#if (configUSE_EDF_TIME_TRIGGERED == 1)
+BaseType_t xTaskTimeTriggeredBuild( void );
+BaseType_t xTaskTimeTriggeredSetTable( const TaskHandle_t * pxTable,
+                                       UBaseType_t uxLength );
+BaseType_t xTaskTimeTriggeredIsActive( void );
+#endif
+
+/*
+ * Best-effort tasks of the stride band, run below the EDF jobs and above
+ * the idle task.  Each one gets a share of the leftover CPU in proportion
+ * to its tickets.
+ */
+#if (configUSE_EDF_STRIDE_BAND == 1)
+BaseType_t xTaskStrideCreate( TaskFunction_t pxTaskCode,
+                              const char * const pcName,
+                              const configSTACK_DEPTH_TYPE usStackDepth,
+                              void * const pvParameters,
+                              UBaseType_t uxTickets,
+                              TaskHandle_t * const pxCreatedTask );
+void vTaskStrideSetTickets( TaskHandle_t xTask,
+                            UBaseType_t uxTickets );
+#endif
+
+/*
+ * Non-preemptive regions of the calling task, they nest.  A preemption
+ * requested inside a region is taken at its end, at a preemption point or
+ * once the region has run for the maxNPR ticks given at creation.
+ */
+#if (configUSE_EDF_LIMITED_PREEMPTION == 1)
+void vTaskEnterNonPreemptiveRegion( void );
+void vTaskExitNonPreemptiveRegion( void );
+void vTaskPreemptionPoint( void );
+#endif
+
+#endif /* configUSE_EDF_SCHEDULER */
+
+#endif /* EDF_TASK_H */
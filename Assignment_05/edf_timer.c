@@ -0,0 +1,147 @@
+/*
+ * Timer service for the EDF scheduler, see edf_timer.h.
+ */
+
+/* Scheduler includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "edf_task.h"
+
+#include "edf_timer.h"
+#include "tick_heap.h"
+
+// Global Variables
+static const EDFTimer_st *pxEDFTimers = NULL;
+static UBaseType_t uxEDFTimerCount = 0;
+static TickType_t xEDFTimerExpiry[ configEDF_TIMER_MAX_TIMERS ]; // Next expiry of every timer
+static uint8_t ucEDFTimerSlots[ configEDF_TIMER_MAX_TIMERS ];
+static TickHeap_st xEDFTimerHeap; // Timers by next expiry
+static uint32_t ulEDFTimerLateCount = 0;
+static StackType_t xEDFTimerStack[ configMINIMAL_STACK_SIZE ];
+static EDFStaticTask_t xEDFTimerTCB;
+
+// Prototypes
+static void prvEDFTimerTask( void *pvParameters );
+static TickType_t prvEDFTimerGCD( TickType_t xA, TickType_t xB );
+
+/*-----------------------------------------------------------*/
+
+static TickType_t prvEDFTimerGCD( TickType_t xA, TickType_t xB )
+{
+	TickType_t xRemainder;
+
+	while( xB != 0 )
+	{
+		xRemainder = xA % xB;
+		xA = xB;
+		xB = xRemainder;
+	}
+
+	return xA;
+}
+/*-----------------------------------------------------------*/
+
+static void prvEDFTimerTask( void *pvParameters )
+{
+	const EDFTimer_st *pxTimer;
+	UBaseType_t uxIndex;
+	uint8_t ucTimer;
+	TickType_t xWakeTime = xTaskGetTickCount();
+
+	( void ) pvParameters;
+
+	// Every timer starts one period from now, the GCD grid is counted from here
+	for( uxIndex = 0; uxIndex < uxEDFTimerCount; uxIndex++ )
+	{
+		xEDFTimerExpiry[ uxIndex ] = xWakeTime + pxEDFTimers[ uxIndex ].xPeriod;
+	}
+
+	vTickHeapInit( &xEDFTimerHeap, ucEDFTimerSlots, xEDFTimerExpiry, uxEDFTimerCount );
+
+	for( ;; )
+	{
+		// The kernel releases the task at the wake time, with the slack as its
+		// relative deadline: the batch is due at the expiry plus the slack
+		vTaskDelayUntil( &xWakeTime, xTickHeapRootKey( &xEDFTimerHeap ) - xWakeTime );
+
+		// Every callback that is due runs in this batch
+		while( !TICK_BEFORE( xWakeTime, xTickHeapRootKey( &xEDFTimerHeap ) ) )
+		{
+			ucTimer = ucTickHeapRoot( &xEDFTimerHeap );
+			pxTimer = &pxEDFTimers[ ucTimer ];
+
+			pxTimer->pxCallback( pxTimer->pvContext );
+
+			// From the expiry, so a late batch does not shift the timer
+			xEDFTimerExpiry[ ucTimer ] += pxTimer->xPeriod;
+			vTickHeapSiftDown( &xEDFTimerHeap, 0 );
+		}
+
+		if( TICK_BEFORE( xWakeTime + configEDF_TIMER_SLACK, xTaskGetTickCount() ) )
+		{
+			ulEDFTimerLateCount++;
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xEDFTimerServiceStart( const EDFTimer_st *pxTimers,
+                                  UBaseType_t uxCount,
+                                  UBaseType_t uxPriority )
+{
+	TaskHandle_t xHandle = NULL;
+	TickType_t xPeriod = 0, xCapacity = 0;
+	UBaseType_t uxIndex;
+	BaseType_t xReturn;
+
+	configASSERT( ( pxTimers != NULL ) && ( uxCount > 0 ) && ( uxCount <= configEDF_TIMER_MAX_TIMERS ) );
+
+	for( uxIndex = 0; uxIndex < uxCount; uxIndex++ )
+	{
+		configASSERT( ( pxTimers[ uxIndex ].pxCallback != NULL ) && ( pxTimers[ uxIndex ].xPeriod > 0 ) );
+
+		xPeriod = prvEDFTimerGCD( pxTimers[ uxIndex ].xPeriod, xPeriod );
+		xCapacity += pxTimers[ uxIndex ].xCapacity;
+	}
+
+	// Two releases are at least xPeriod apart, each batch is due within the slack
+	configASSERT( ( configEDF_TIMER_SLACK > 0 ) && ( configEDF_TIMER_SLACK <= xPeriod ) );
+
+	if( xCapacity > configEDF_TIMER_SLACK )
+	{
+		return EDF_TIMER_NOT_SCHEDULABLE;
+	}
+
+	pxEDFTimers = pxTimers;
+	uxEDFTimerCount = uxCount;
+
+	// Admitted with its deadline at creation, nothing is created when it is rejected
+	xReturn = xTaskPeriodicCreateStatic( prvEDFTimerTask,
+	                                     "Timers",
+	                                     configMINIMAL_STACK_SIZE,
+	                                     NULL,
+	                                     uxPriority,
+	                                     &xHandle,
+	                                     xEDFTimerStack,
+	                                     &xEDFTimerTCB,
+	                                     xPeriod,
+	                                     configEDF_TIMER_SLACK,
+	                                     xCapacity,
+	                                     0 );
+
+	if( xReturn != pdPASS )
+	{
+		pxEDFTimers = NULL;
+		uxEDFTimerCount = 0;
+
+		return ( xReturn == errEDF_TASK_NOT_SCHEDULABLE ) ? EDF_TIMER_NOT_SCHEDULABLE : pdFAIL;
+	}
+
+	return pdPASS;
+}
+/*-----------------------------------------------------------*/
+
+uint32_t ulEDFTimerGetLateCount( void )
+{
+	return ulEDFTimerLateCount;
+}
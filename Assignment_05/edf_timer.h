@@ -0,0 +1,69 @@
+/*
+ * Timer service for the EDF scheduler.
+ *
+ * Periodic timers share one service task, which the kernel schedules like any
+ * other EDF task.  The task sleeps until the earliest expiry and is released
+ * there, so the deadline of each batch is that expiry plus
+ * configEDF_TIMER_SLACK.  Every callback that is due at the release runs in
+ * that batch.  The timers are kept in a heap ordered by their next expiry.
+ *
+ * Every expiry lies on a multiple of the GCD of the timer periods, counted
+ * from the start of the service.  So the service is admitted as a sporadic
+ * task with the GCD as its period, configEDF_TIMER_SLACK as its deadline and
+ * the sum of the callback capacities as its capacity (the cost of a batch
+ * where every timer is due).
+ *
+ * The service task and its stack are static, so configSUPPORT_STATIC_ALLOCATION
+ * must be 1.  The timer heap is common/tick_heap.c, add it to the project.
+ */
+
+#ifndef EDF_TIMER_H
+#define EDF_TIMER_H
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#if ( configSUPPORT_STATIC_ALLOCATION != 1 )
+	#error "The EDF timer service needs configSUPPORT_STATIC_ALLOCATION set to 1"
+#endif
+
+// Max number of timers handled by the service
+#ifndef configEDF_TIMER_MAX_TIMERS
+	#define configEDF_TIMER_MAX_TIMERS 8
+#endif
+
+// Relative deadline of a batch, counted from the expiry that released it
+#ifndef configEDF_TIMER_SLACK
+	#define configEDF_TIMER_SLACK ( ( TickType_t ) 2U )
+#endif
+
+// Returned by xEDFTimerServiceStart() when the service fails the admission test
+#define EDF_TIMER_NOT_SCHEDULABLE ( ( BaseType_t ) -6 )
+
+// Type definitions
+typedef void ( * EDFTimerCallback_t )( void *pvContext );
+
+typedef struct
+{
+	EDFTimerCallback_t pxCallback;
+	void *pvContext;
+	TickType_t xPeriod;
+	TickType_t xCapacity; // Worst case execution time of the callback in ticks
+} EDFTimer_st;
+
+/*
+ * Creates the service task at uxPriority, running uxCount timers from
+ * pxTimers (used in place, keep the table alive).  The first expiry of every
+ * timer is one period after the service starts.  Call it once, before the
+ * scheduler starts.  Returns pdPASS, EDF_TIMER_NOT_SCHEDULABLE or pdFAIL.
+ */
+BaseType_t xEDFTimerServiceStart( const EDFTimer_st *pxTimers,
+                                  UBaseType_t uxCount,
+                                  UBaseType_t uxPriority );
+
+/*
+ * Returns the number of batches that ended after their deadline.
+ */
+uint32_t ulEDFTimerGetLateCount( void );
+
+#endif /* EDF_TIMER_H */
@@ -0,0 +1,339 @@
+/*
+ * Elastic task manager for the EDF scheduler, see elastic.h.
+ */
+
+/* Scheduler includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "edf_task.h"
+
+#include "elastic.h"
+
+// Rounded up division, keeps the utilization figures on the safe side
+#define DIV_ROUND_UP(a, b) ( ( ( a ) + ( b ) - 1UL ) / ( b ) )
+
+// Type definitions
+typedef struct
+{
+	TaskHandle_t xHandle;
+	TickType_t xCapacity;
+	TickType_t xMinPeriod;
+	TickType_t xMaxPeriod;
+	TickType_t xPeriod; // Period currently given to the kernel
+	TickType_t xAppliedCapacity; // Capacity currently given to the kernel
+	uint32_t ulUtilization; // Utilization chosen by the last compression
+	uint8_t ucElasticity;
+} ElasticTask_st;
+
+// Global Variables
+static ElasticTask_st xElasticTasks[ configELASTIC_MAX_TASKS ];
+static UBaseType_t uxElasticTaskCount = 0;
+static uint32_t ulTargetUtilization = configELASTIC_TARGET_UTILIZATION;
+
+// Prototypes
+static ElasticTask_st * prvElasticFind( TaskHandle_t xTask );
+static BaseType_t prvElasticCompress( void );
+static BaseType_t prvElasticApply( void );
+
+/*-----------------------------------------------------------*/
+
+static ElasticTask_st * prvElasticFind( TaskHandle_t xTask )
+{
+	UBaseType_t uxIndex;
+
+	for( uxIndex = 0; uxIndex < uxElasticTaskCount; uxIndex++ )
+	{
+		if( xElasticTasks[ uxIndex ].xHandle == xTask )
+		{
+			return &xElasticTasks[ uxIndex ];
+		}
+	}
+
+	return NULL;
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * Computes the utilization of every managed task.  Rigid tasks and tasks
+ * already clamped at Tmax are fixed, the excess over the target is shared by
+ * the others in proportion to their elasticity.  Clamping a task changes the
+ * share of the others, so the loop runs until no new task gets clamped (at
+ * most once per task).
+ */
+static BaseType_t prvElasticCompress( void )
+{
+	ElasticTask_st *pxTask;
+	UBaseType_t uxIndex;
+	uint32_t ulClampedMask = 0, ulFixed, ulVariable, ulElasticity, ulExcess;
+	uint32_t ulMaxUtilization, ulMinUtilization, ulReduction;
+	BaseType_t xClampedNewTask;
+
+	configASSERT( configELASTIC_MAX_TASKS <= 32 );
+
+	do
+	{
+		ulFixed = 0;
+		ulVariable = 0;
+		ulElasticity = 0;
+
+		for( uxIndex = 0; uxIndex < uxElasticTaskCount; uxIndex++ )
+		{
+			pxTask = &xElasticTasks[ uxIndex ];
+			ulMaxUtilization = DIV_ROUND_UP( pxTask->xCapacity * ELASTIC_UTILIZATION_SCALE, pxTask->xMinPeriod );
+			ulMinUtilization = DIV_ROUND_UP( pxTask->xCapacity * ELASTIC_UTILIZATION_SCALE, pxTask->xMaxPeriod );
+
+			if( pxTask->ucElasticity == ELASTIC_RIGID )
+			{
+				pxTask->ulUtilization = ulMaxUtilization;
+				ulFixed += ulMaxUtilization;
+			}
+			else if( ( ulClampedMask & ( 1UL << uxIndex ) ) != 0 )
+			{
+				pxTask->ulUtilization = ulMinUtilization;
+				ulFixed += ulMinUtilization;
+			}
+			else
+			{
+				pxTask->ulUtilization = ulMaxUtilization;
+				ulVariable += ulMaxUtilization;
+				ulElasticity += pxTask->ucElasticity;
+			}
+		}
+
+		// Everything fits at the shortest periods
+		if( ( ulFixed + ulVariable ) <= ulTargetUtilization )
+		{
+			return pdPASS;
+		}
+
+		// Nothing left to compress, stretch every elastic task to Tmax
+		if( ( ulFixed >= ulTargetUtilization ) || ( ulElasticity == 0 ) )
+		{
+			for( uxIndex = 0; uxIndex < uxElasticTaskCount; uxIndex++ )
+			{
+				pxTask = &xElasticTasks[ uxIndex ];
+
+				if( pxTask->ucElasticity != ELASTIC_RIGID )
+				{
+					pxTask->ulUtilization = DIV_ROUND_UP( pxTask->xCapacity * ELASTIC_UTILIZATION_SCALE, pxTask->xMaxPeriod );
+				}
+			}
+
+			return pdFAIL;
+		}
+
+		ulExcess = ( ulFixed + ulVariable ) - ulTargetUtilization;
+		xClampedNewTask = pdFALSE;
+
+		for( uxIndex = 0; uxIndex < uxElasticTaskCount; uxIndex++ )
+		{
+			pxTask = &xElasticTasks[ uxIndex ];
+
+			if( ( pxTask->ucElasticity == ELASTIC_RIGID ) || ( ( ulClampedMask & ( 1UL << uxIndex ) ) != 0 ) )
+			{
+				continue;
+			}
+
+			ulMinUtilization = DIV_ROUND_UP( pxTask->xCapacity * ELASTIC_UTILIZATION_SCALE, pxTask->xMaxPeriod );
+			ulReduction = DIV_ROUND_UP( ulExcess * pxTask->ucElasticity, ulElasticity );
+
+			if( ( pxTask->ulUtilization < ulReduction ) || ( ( pxTask->ulUtilization - ulReduction ) < ulMinUtilization ) )
+			{
+				ulClampedMask |= ( 1UL << uxIndex );
+				xClampedNewTask = pdTRUE;
+			}
+			else
+			{
+				pxTask->ulUtilization -= ulReduction;
+			}
+		}
+	} while( xClampedNewTask != pdFALSE );
+
+	return pdPASS;
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * Hands the new periods to the kernel.  Tasks whose utilization drops go first
+ * so the admission test never sees the grown and the old figures together.
+ */
+static BaseType_t prvElasticApply( void )
+{
+	ElasticTask_st *pxTask;
+	UBaseType_t uxIndex, uxPass;
+	TickType_t xNewPeriod;
+	BaseType_t xUtilizationDrops, xReturn = pdPASS;
+
+	for( uxPass = 0; uxPass < 2; uxPass++ )
+	{
+		for( uxIndex = 0; uxIndex < uxElasticTaskCount; uxIndex++ )
+		{
+			pxTask = &xElasticTasks[ uxIndex ];
+			xNewPeriod = ( TickType_t ) DIV_ROUND_UP( pxTask->xCapacity * ELASTIC_UTILIZATION_SCALE, pxTask->ulUtilization );
+
+			if( xNewPeriod < pxTask->xMinPeriod )
+			{
+				xNewPeriod = pxTask->xMinPeriod;
+			}
+			else if( xNewPeriod > pxTask->xMaxPeriod )
+			{
+				xNewPeriod = pxTask->xMaxPeriod;
+			}
+
+			if( ( xNewPeriod == pxTask->xPeriod ) && ( pxTask->xCapacity == pxTask->xAppliedCapacity ) )
+			{
+				continue;
+			}
+
+			// First pass: C/T decreases, second pass: C/T increases
+			xUtilizationDrops = ( ( pxTask->xCapacity * pxTask->xPeriod ) <= ( pxTask->xAppliedCapacity * xNewPeriod ) ) ? pdTRUE : pdFALSE;
+
+			if( ( ( uxPass == 0 ) && ( xUtilizationDrops != pdFALSE ) ) ||
+				( ( uxPass == 1 ) && ( xUtilizationDrops == pdFALSE ) ) )
+			{
+				if( xTaskPeriodicSetParameters( pxTask->xHandle, xNewPeriod, xNewPeriod, pxTask->xCapacity ) == pdPASS )
+				{
+					pxTask->xPeriod = xNewPeriod;
+					pxTask->xAppliedCapacity = pxTask->xCapacity;
+				}
+				else
+				{
+					xReturn = pdFAIL;
+				}
+			}
+		}
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xElasticTaskRegister( TaskHandle_t xTask,
+                                 TickType_t xCapacity,
+                                 TickType_t xMinPeriod,
+                                 TickType_t xMaxPeriod,
+                                 uint8_t ucElasticity )
+{
+	ElasticTask_st *pxTask;
+	BaseType_t xReturn = pdFAIL;
+
+	configASSERT( ( xCapacity > 0 ) && ( xCapacity <= xMinPeriod ) && ( xMinPeriod <= xMaxPeriod ) );
+
+	vTaskSuspendAll();
+	{
+		if( ( prvElasticFind( xTask ) == NULL ) && ( uxElasticTaskCount < configELASTIC_MAX_TASKS ) )
+		{
+			pxTask = &xElasticTasks[ uxElasticTaskCount ];
+			pxTask->xHandle = xTask;
+			pxTask->xCapacity = xCapacity;
+			pxTask->xMinPeriod = xMinPeriod;
+			pxTask->xMaxPeriod = xMaxPeriod;
+			pxTask->xPeriod = xTaskGetPeriod( xTask );
+			pxTask->xAppliedCapacity = 0; // Unknown, always handed to the kernel
+			pxTask->ucElasticity = ucElasticity;
+			uxElasticTaskCount++;
+
+			xReturn = prvElasticCompress();
+
+			if( prvElasticApply() != pdPASS )
+			{
+				xReturn = pdFAIL;
+			}
+		}
+	}
+	( void ) xTaskResumeAll();
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vElasticTaskUnregister( TaskHandle_t xTask )
+{
+	ElasticTask_st *pxTask;
+
+	vTaskSuspendAll();
+	{
+		pxTask = prvElasticFind( xTask );
+
+		if( pxTask != NULL )
+		{
+			// Keep the table packed, the order is irrelevant
+			uxElasticTaskCount--;
+			*pxTask = xElasticTasks[ uxElasticTaskCount ];
+
+			( void ) prvElasticCompress();
+			( void ) prvElasticApply();
+		}
+	}
+	( void ) xTaskResumeAll();
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xElasticSetCapacity( TaskHandle_t xTask,
+                                TickType_t xCapacity )
+{
+	ElasticTask_st *pxTask;
+	BaseType_t xReturn = pdFAIL;
+
+	vTaskSuspendAll();
+	{
+		pxTask = prvElasticFind( xTask );
+
+		if( pxTask != NULL )
+		{
+			configASSERT( ( xCapacity > 0 ) && ( xCapacity <= pxTask->xMinPeriod ) );
+			pxTask->xCapacity = xCapacity;
+
+			xReturn = prvElasticCompress();
+
+			if( prvElasticApply() != pdPASS )
+			{
+				xReturn = pdFAIL;
+			}
+		}
+	}
+	( void ) xTaskResumeAll();
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xElasticSetTargetUtilization( uint32_t ulTarget )
+{
+	BaseType_t xReturn;
+
+	configASSERT( ulTarget <= ELASTIC_UTILIZATION_SCALE );
+
+	vTaskSuspendAll();
+	{
+		ulTargetUtilization = ulTarget;
+
+		xReturn = prvElasticCompress();
+
+		if( prvElasticApply() != pdPASS )
+		{
+			xReturn = pdFAIL;
+		}
+	}
+	( void ) xTaskResumeAll();
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+uint32_t ulElasticGetUtilization( void )
+{
+	UBaseType_t uxIndex;
+	uint32_t ulUtilization = 0;
+
+	vTaskSuspendAll();
+	{
+		for( uxIndex = 0; uxIndex < uxElasticTaskCount; uxIndex++ )
+		{
+			ulUtilization += DIV_ROUND_UP( xElasticTasks[ uxIndex ].xCapacity * ELASTIC_UTILIZATION_SCALE, xElasticTasks[ uxIndex ].xPeriod );
+		}
+	}
+	( void ) xTaskResumeAll();
+
+	return ulUtilization;
+}
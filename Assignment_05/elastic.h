@@ -0,0 +1,73 @@
+/*
+ * Elastic task manager for the EDF scheduler.
+ *
+ * Every managed task has a capacity C, a period range [Tmin, Tmax] and an
+ * elasticity coefficient E.  When the utilization of the managed tasks at
+ * their shortest periods goes above the target, the periods are stretched in
+ * proportion to E (Buttazzo's elastic task model).  When the load drops they
+ * shrink back towards Tmin.  New periods are passed to the kernel through
+ * xTaskPeriodicSetParameters() so they take effect at the next job boundary.
+ *
+ * Managed tasks must wait for their next release with
+ * xTaskDelayUntilNextPeriod() to follow the period chosen by the manager.
+ */
+
+#ifndef ELASTIC_H
+#define ELASTIC_H
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "edf_task.h"
+
+// Max number of tasks handled by the manager
+#ifndef configELASTIC_MAX_TASKS
+	#define configELASTIC_MAX_TASKS configEDF_MAX_PERIODIC_TASKS
+#endif
+
+// Utilization reached by 100 % of the CPU
+#define ELASTIC_UTILIZATION_SCALE ( ( uint32_t ) 10000UL )
+
+// Default utilization target of the managed tasks (90 %)
+#ifndef configELASTIC_TARGET_UTILIZATION
+	#define configELASTIC_TARGET_UTILIZATION ( ( uint32_t ) 9000UL )
+#endif
+
+// Elasticity of a task that must keep its shortest period
+#define ELASTIC_RIGID ( ( uint8_t ) 0U )
+
+/*
+ * Puts an already created periodic task under control of the manager and
+ * recomputes all the periods.  Returns pdFAIL if the table is full or if the
+ * managed set cannot fit in the target even with every period at Tmax.
+ */
+BaseType_t xElasticTaskRegister( TaskHandle_t xTask,
+                                 TickType_t xCapacity,
+                                 TickType_t xMinPeriod,
+                                 TickType_t xMaxPeriod,
+                                 uint8_t ucElasticity );
+
+/*
+ * Releases a task from the manager.  Its last period is kept and the periods
+ * of the remaining tasks are expanded back if possible.
+ */
+void vElasticTaskUnregister( TaskHandle_t xTask );
+
+/*
+ * Updates the capacity of a managed task, for example when extra work is
+ * attached to it, and recomputes all the periods.
+ */
+BaseType_t xElasticSetCapacity( TaskHandle_t xTask,
+                                TickType_t xCapacity );
+
+/*
+ * Changes the utilization target (ELASTIC_UTILIZATION_SCALE is 100 %) and
+ * recomputes all the periods.
+ */
+BaseType_t xElasticSetTargetUtilization( uint32_t ulTarget );
+
+/*
+ * Returns the utilization of the managed tasks with their current periods.
+ */
+uint32_t ulElasticGetUtilization( void );
+
+#endif /* ELASTIC_H */
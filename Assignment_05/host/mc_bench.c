@@ -0,0 +1,184 @@
+/*
+ * Multicore EDF benchmark, see mc_edf.h.
+ *
+ * Generates random task sets (UUniFast-discard utilizations, periods
+ * dividing 200 ticks, implicit deadlines) of 4 tasks per core, and reports
+ * for 1, 2, 4 and 8 cores the share of the sets each partitioner places
+ * and the share global EDF runs without a miss in the simulator.  Every set
+ * accepted by a partitioner is replayed by the simulator, which must see no
+ * miss.  The schedulable load is the weighted schedulable utilization times
+ * the core count, in cores: it should grow linearly with the core count.
+ *
+ * For global EDF the benchmark also prints the migrations per job and the
+ * share of the shared queue accesses made in a tick where another core
+ * accessed the queue too.  The semi-partitioner (first-fit with C=D
+ * splitting) is checked against the simulator like the partitioners, and
+ * reported with the average number of split tasks in the sets it accepts.
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "mc_edf.h"
+
+// Lowest and highest normalized utilization of the sweep, in percent
+#define BENCH_UTILIZATION_FIRST 60
+#define BENCH_UTILIZATION_LAST 100
+#define BENCH_UTILIZATION_STEP 5
+
+#define BENCH_TASKS_PER_CORE 4
+
+// Global Variables
+static const uint32_t ulBenchPeriods[] = { 5, 8, 10, 20, 25, 40, 50, 100, 200 };
+static uint32_t ulBenchSeed = 1;
+
+/*-----------------------------------------------------------*/
+
+static double prvRandom( void )
+{
+	// xorshift32, reproducible from the seed on every host
+	ulBenchSeed ^= ulBenchSeed << 13;
+	ulBenchSeed ^= ulBenchSeed >> 17;
+	ulBenchSeed ^= ulBenchSeed << 5;
+
+	return ( double ) ulBenchSeed / 4294967296.0;
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * UUniFast-discard: uiCount utilizations summing to dTotal, none above 1,
+ * turned into integer capacities.
+ */
+static void prvBenchGenerate( McTask_st *pxTasks, unsigned int uiCount, double dTotal )
+{
+	double dUtilization[ MC_MAX_TASKS ], dSum, dNext;
+	unsigned int uiIndex;
+	int iValid;
+
+	do
+	{
+		dSum = dTotal;
+		iValid = 1;
+
+		for( uiIndex = 0; uiIndex + 1 < uiCount; uiIndex++ )
+		{
+			dNext = dSum * pow( prvRandom(), 1.0 / ( uiCount - uiIndex - 1 ) );
+			dUtilization[ uiIndex ] = dSum - dNext;
+			dSum = dNext;
+		}
+
+		dUtilization[ uiCount - 1 ] = dSum;
+
+		for( uiIndex = 0; uiIndex < uiCount; uiIndex++ )
+		{
+			iValid &= ( dUtilization[ uiIndex ] <= 1.0 );
+		}
+	} while( !iValid );
+
+	for( uiIndex = 0; uiIndex < uiCount; uiIndex++ )
+	{
+		pxTasks[ uiIndex ].ulPeriod = ulBenchPeriods[ ( unsigned int ) ( prvRandom() * ( sizeof( ulBenchPeriods ) / sizeof( ulBenchPeriods[ 0 ] ) ) ) ];
+		pxTasks[ uiIndex ].ulDeadline = pxTasks[ uiIndex ].ulPeriod;
+		pxTasks[ uiIndex ].ulCapacity = ( uint32_t ) ( ( dUtilization[ uiIndex ] * pxTasks[ uiIndex ].ulPeriod ) + 0.5 );
+
+		if( pxTasks[ uiIndex ].ulCapacity == 0 )
+		{
+			pxTasks[ uiIndex ].ulCapacity = 1;
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+int main( int argc, char **argv )
+{
+	static const unsigned int uiCores[] = { 1, 2, 4, 8 };
+	McTask_st xTasks[ MC_MAX_TASKS ];
+	McPartition_st xPartition;
+	McSemiPartition_st xSemiPartition;
+	McSimStats_st xStats;
+	unsigned int uiSets = 200, uiCore, uiSet, uiCount, uiFirstFit, uiWorstFit, uiGlobal, uiSemi;
+	unsigned int uiMismatches = 0;
+	unsigned long ulJobs, ulMigrations, ulAccesses, ulConflicts, ulSplits;
+	double dTotal, dWeighted[ 4 ], dWeights;
+	int iPercent;
+
+	if( argc > 1 )
+	{
+		uiSets = ( unsigned int ) strtoul( argv[ 1 ], NULL, 0 );
+	}
+
+	if( argc > 2 )
+	{
+		ulBenchSeed = ( uint32_t ) strtoul( argv[ 2 ], NULL, 0 ) | 1;
+	}
+
+	printf( "cores  U/m   first-fit  worst-fit  semi   splits  global  migrations/job  conflicts\n" );
+
+	for( uiCore = 0; uiCore < sizeof( uiCores ) / sizeof( uiCores[ 0 ] ); uiCore++ )
+	{
+		uiCount = BENCH_TASKS_PER_CORE * uiCores[ uiCore ];
+		dWeighted[ 0 ] = dWeighted[ 1 ] = dWeighted[ 2 ] = dWeighted[ 3 ] = dWeights = 0.0;
+
+		for( iPercent = BENCH_UTILIZATION_FIRST; iPercent <= BENCH_UTILIZATION_LAST; iPercent += BENCH_UTILIZATION_STEP )
+		{
+			dTotal = ( iPercent / 100.0 ) * uiCores[ uiCore ];
+			uiFirstFit = uiWorstFit = uiGlobal = uiSemi = 0;
+			ulJobs = ulMigrations = ulAccesses = ulConflicts = ulSplits = 0;
+
+			for( uiSet = 0; uiSet < uiSets; uiSet++ )
+			{
+				prvBenchGenerate( xTasks, uiCount, dTotal );
+
+				if( iMcPartition( xTasks, uiCount, uiCores[ uiCore ], MC_FIRST_FIT, &xPartition ) )
+				{
+					uiFirstFit++;
+					uiMismatches += !iMcSimulatePartitioned( xTasks, uiCount, &xPartition, &xStats );
+				}
+
+				if( iMcPartition( xTasks, uiCount, uiCores[ uiCore ], MC_WORST_FIT, &xPartition ) )
+				{
+					uiWorstFit++;
+					uiMismatches += !iMcSimulatePartitioned( xTasks, uiCount, &xPartition, &xStats );
+				}
+
+				if( iMcPartitionSemi( xTasks, uiCount, uiCores[ uiCore ], &xSemiPartition ) )
+				{
+					uiSemi++;
+					ulSplits += xSemiPartition.uiSplitCount;
+					uiMismatches += !iMcSimulateSemi( &xSemiPartition, &xStats );
+				}
+
+				uiGlobal += iMcSimulateGlobal( xTasks, uiCount, uiCores[ uiCore ], &xStats );
+				ulJobs += xStats.ulJobs;
+				ulMigrations += xStats.ulMigrations;
+				ulAccesses += xStats.ulQueueAccesses;
+				ulConflicts += xStats.ulQueueConflicts;
+			}
+
+			printf( "%5u  %.2f  %9.3f  %9.3f  %5.3f  %6.2f  %6.3f  %14.3f  %9.3f\n", uiCores[ uiCore ], iPercent / 100.0,
+					( double ) uiFirstFit / uiSets, ( double ) uiWorstFit / uiSets, ( double ) uiSemi / uiSets,
+					uiSemi ? ( double ) ulSplits / uiSemi : 0.0, ( double ) uiGlobal / uiSets,
+					( double ) ulMigrations / ulJobs, ( double ) ulConflicts / ulAccesses );
+
+			dWeighted[ 0 ] += dTotal * uiFirstFit / uiSets;
+			dWeighted[ 1 ] += dTotal * uiWorstFit / uiSets;
+			dWeighted[ 2 ] += dTotal * uiGlobal / uiSets;
+			dWeighted[ 3 ] += dTotal * uiSemi / uiSets;
+			dWeights += dTotal;
+		}
+
+		printf( "%5u  schedulable load (cores): first-fit %.2f, worst-fit %.2f, semi %.2f, global %.2f\n\n", uiCores[ uiCore ],
+				uiCores[ uiCore ] * dWeighted[ 0 ] / dWeights, uiCores[ uiCore ] * dWeighted[ 1 ] / dWeights,
+				uiCores[ uiCore ] * dWeighted[ 3 ] / dWeights, uiCores[ uiCore ] * dWeighted[ 2 ] / dWeights );
+	}
+
+	if( uiMismatches > 0 )
+	{
+		printf( "%u accepted sets missed a deadline in the simulator\n", uiMismatches );
+		return 1;
+	}
+
+	return 0;
+}
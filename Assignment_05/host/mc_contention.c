@@ -0,0 +1,211 @@
+/*
+ * Lock contention on a global EDF ready queue, see mc_edf.h.
+ *
+ * One POSIX thread per core dispatches jobs from a shared deadline heap
+ * behind one mutex: take the earliest deadline, run the job (a short busy
+ * loop), put the next job of the task back with its new deadline.  For 1 to
+ * 8 threads and 8 to 128 tasks it prints the queue operations per second and
+ * the share of the lock acquisitions that found the mutex taken.
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <time.h>
+
+#include "mc_edf.h"
+
+// Busy loop iterations standing for the execution of a job
+#define CONTENTION_JOB_WORK 200
+
+#define CONTENTION_MAX_TASKS 128
+
+// Type definitions
+typedef struct
+{
+	uint64_t ullDeadline;
+	uint32_t ulPeriod;
+} ContentionJob_st;
+
+typedef struct
+{
+	unsigned long ulOperations;
+	unsigned long ulConflicts;
+} ContentionCount_st;
+
+// Global Variables
+static pthread_mutex_t xQueueLock = PTHREAD_MUTEX_INITIALIZER;
+static ContentionJob_st xQueue[ CONTENTION_MAX_TASKS ];
+static unsigned int uiQueueLength = 0;
+static volatile int iStop = 0;
+
+/*-----------------------------------------------------------*/
+
+static void prvQueuePush( ContentionJob_st xJob )
+{
+	unsigned int uiSlot = uiQueueLength++;
+
+	while( ( uiSlot > 0 ) && ( xQueue[ ( uiSlot - 1 ) / 2 ].ullDeadline > xJob.ullDeadline ) )
+	{
+		xQueue[ uiSlot ] = xQueue[ ( uiSlot - 1 ) / 2 ];
+		uiSlot = ( uiSlot - 1 ) / 2;
+	}
+
+	xQueue[ uiSlot ] = xJob;
+}
+/*-----------------------------------------------------------*/
+
+static ContentionJob_st prvQueuePop( void )
+{
+	ContentionJob_st xEarliest = xQueue[ 0 ], xLast = xQueue[ --uiQueueLength ];
+	unsigned int uiSlot = 0, uiChild;
+
+	for( ;; )
+	{
+		uiChild = ( 2 * uiSlot ) + 1;
+
+		if( uiChild >= uiQueueLength )
+		{
+			break;
+		}
+
+		if( ( ( uiChild + 1 ) < uiQueueLength ) && ( xQueue[ uiChild + 1 ].ullDeadline < xQueue[ uiChild ].ullDeadline ) )
+		{
+			uiChild++;
+		}
+
+		if( xQueue[ uiChild ].ullDeadline >= xLast.ullDeadline )
+		{
+			break;
+		}
+
+		xQueue[ uiSlot ] = xQueue[ uiChild ];
+		uiSlot = uiChild;
+	}
+
+	xQueue[ uiSlot ] = xLast;
+
+	return xEarliest;
+}
+/*-----------------------------------------------------------*/
+
+static void prvQueueLock( ContentionCount_st *pxCount )
+{
+	if( pthread_mutex_trylock( &xQueueLock ) != 0 )
+	{
+		pxCount->ulConflicts++;
+		pthread_mutex_lock( &xQueueLock );
+	}
+
+	pxCount->ulOperations++;
+}
+/*-----------------------------------------------------------*/
+
+static void *prvCoreThread( void *pvCount )
+{
+	ContentionCount_st *pxCount = pvCount;
+	ContentionJob_st xJob;
+	volatile unsigned int uiWork;
+	int iHaveJob;
+
+	while( !iStop )
+	{
+		prvQueueLock( pxCount );
+		iHaveJob = ( uiQueueLength > 0 );
+
+		if( iHaveJob )
+		{
+			xJob = prvQueuePop();
+		}
+
+		pthread_mutex_unlock( &xQueueLock );
+
+		if( !iHaveJob )
+		{
+			continue;
+		}
+
+		for( uiWork = 0; uiWork < CONTENTION_JOB_WORK; uiWork++ )
+		{
+		}
+
+		// Next job of the task
+		xJob.ullDeadline += xJob.ulPeriod;
+
+		prvQueueLock( pxCount );
+		prvQueuePush( xJob );
+		pthread_mutex_unlock( &xQueueLock );
+	}
+
+	return NULL;
+}
+/*-----------------------------------------------------------*/
+
+static void prvRunPoint( unsigned int uiThreads, unsigned int uiTasks, unsigned int uiMilliseconds )
+{
+	static const uint32_t ulPeriods[] = { 5, 8, 10, 20, 25, 40, 50, 100, 200 };
+	pthread_t xThreads[ MC_MAX_CORES ];
+	ContentionCount_st xCounts[ MC_MAX_CORES ] = { { 0, 0 } };
+	ContentionJob_st xJob;
+	struct timespec xSleep;
+	unsigned long ulOperations = 0, ulConflicts = 0;
+	unsigned int uiIndex;
+
+	uiQueueLength = 0;
+
+	for( uiIndex = 0; uiIndex < uiTasks; uiIndex++ )
+	{
+		xJob.ulPeriod = ulPeriods[ uiIndex % ( sizeof( ulPeriods ) / sizeof( ulPeriods[ 0 ] ) ) ];
+		xJob.ullDeadline = xJob.ulPeriod;
+		prvQueuePush( xJob );
+	}
+
+	iStop = 0;
+
+	for( uiIndex = 0; uiIndex < uiThreads; uiIndex++ )
+	{
+		pthread_create( &xThreads[ uiIndex ], NULL, prvCoreThread, &xCounts[ uiIndex ] );
+	}
+
+	xSleep.tv_sec = uiMilliseconds / 1000;
+	xSleep.tv_nsec = ( long ) ( uiMilliseconds % 1000 ) * 1000000L;
+	nanosleep( &xSleep, NULL );
+	iStop = 1;
+
+	for( uiIndex = 0; uiIndex < uiThreads; uiIndex++ )
+	{
+		pthread_join( xThreads[ uiIndex ], NULL );
+		ulOperations += xCounts[ uiIndex ].ulOperations;
+		ulConflicts += xCounts[ uiIndex ].ulConflicts;
+	}
+
+	printf( "%7u  %5u  %13.0f  %9.3f\n", uiThreads, uiTasks,
+			ulOperations * 1000.0 / uiMilliseconds, ( double ) ulConflicts / ulOperations );
+}
+/*-----------------------------------------------------------*/
+
+int main( int argc, char **argv )
+{
+	static const unsigned int uiThreads[] = { 1, 2, 4, 8 };
+	static const unsigned int uiTasks[] = { 8, 32, 128 };
+	unsigned int uiMilliseconds = 200, uiThread, uiTask;
+
+	if( argc > 1 )
+	{
+		uiMilliseconds = ( unsigned int ) strtoul( argv[ 1 ], NULL, 0 );
+	}
+
+	printf( "threads  tasks  operations/s  conflicts\n" );
+
+	for( uiTask = 0; uiTask < sizeof( uiTasks ) / sizeof( uiTasks[ 0 ] ); uiTask++ )
+	{
+		for( uiThread = 0; uiThread < sizeof( uiThreads ) / sizeof( uiThreads[ 0 ] ); uiThread++ )
+		{
+			prvRunPoint( uiThreads[ uiThread ], uiTasks[ uiTask ], uiMilliseconds );
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,173 @@
+/*
+ * Multicore EDF models for the host.
+ *
+ * The kernel in this assignment runs on a single core (one ready list, one
+ * pxCurrentTCB).  These files model the multicore variants on the PC, on
+ * synchronous periodic task sets with the timing parameters of
+ * xTaskPeriodicCreate(), so they can be compared before a multicore port
+ * exists:
+ *
+ *  - the partitioner assigns tasks to cores with first-fit or worst-fit
+ *    decreasing utilization, admitting each task with a per-core demand bound
+ *    test;
+ *  - the semi-partitioner does the same with first-fit, and splits a task
+ *    that fits on no core into pieces on several cores (C=D splitting);
+ *  - the simulator replays a task set tick by tick over its hyperperiod,
+ *    either with one EDF ready queue per core (partitioned and
+ *    semi-partitioned) or with one shared queue feeding every core (global),
+ *    and counts the deadline
+ *    misses, preemptions and migrations;
+ *  - mc_contention.c measures the lock of a shared ready queue with one
+ *    POSIX thread per core.
+ *
+ * Build and run the benchmarks from this directory:
+ *
+ *     gcc -O2 -o mc_bench mc_partition.c mc_sim.c mc_bench.c -lm
+ *     ./mc_bench [sets per point] [seed]
+ *     gcc -O2 -pthread -o mc_contention mc_contention.c
+ *     ./mc_contention [milliseconds per point]
+ */
+
+#ifndef MC_EDF_H
+#define MC_EDF_H
+
+/* Standard includes. */
+#include <stdint.h>
+
+// Limits of the models
+#define MC_MAX_CORES 8
+#define MC_MAX_TASKS 64
+
+// Longest hyperperiod the demand bound test and the simulator go through, in ticks
+#define MC_MAX_HYPERPERIOD 2000UL
+
+// Pieces of a semi-partitioned task set
+#define MC_MAX_PIECES ( MC_MAX_TASKS + MC_MAX_CORES )
+
+// Utilization reached by 100 % of a core, same scale as the kernel admission test
+#define MC_UTILIZATION_SCALE 10000UL
+
+// Type definitions
+typedef struct
+{
+	uint32_t ulPeriod;
+	uint32_t ulDeadline; // Relative, never longer than the period
+	uint32_t ulCapacity; // Worst case execution time
+} McTask_st;
+
+typedef enum
+{
+	MC_FIRST_FIT, // First core that admits the task
+	MC_WORST_FIT // Least loaded core that admits the task
+} McHeuristic_t;
+
+typedef struct
+{
+	unsigned int uiCoreCount;
+	int iCore[ MC_MAX_TASKS ]; // Core of every task, -1 if it did not fit
+} McPartition_st;
+
+typedef struct
+{
+	unsigned int uiTask; // Index of the task the piece belongs to
+	int iCore;
+	uint32_t ulOffset; // Release of the piece after the release of the job
+	McTask_st xPiece; // Period of the task, deadline and capacity of the piece
+} McPiece_st;
+
+typedef struct
+{
+	unsigned int uiCoreCount;
+	unsigned int uiPieceCount;
+	unsigned int uiSplitCount; // Tasks cut in more than one piece
+	McPiece_st xPieces[ MC_MAX_PIECES ];
+} McSemiPartition_st;
+
+typedef struct
+{
+	unsigned long ulJobs;
+	unsigned long ulMisses; // Jobs not finished by their deadline
+	unsigned long ulPreemptions;
+	unsigned long ulMigrations; // Jobs resumed on another core than the one they left
+	unsigned long ulQueueAccesses; // Inserts and removals on the shared queue (global only)
+	unsigned long ulQueueConflicts; // Accesses made in a tick where several cores accessed it
+} McSimStats_st;
+
+/*
+ * Utilization of a task, rounded up like the kernel admission test.
+ */
+uint32_t ulMcUtilization( const McTask_st *pxTask );
+
+/*
+ * Least common multiple of the periods, 0 above MC_MAX_HYPERPERIOD.
+ */
+uint32_t ulMcHyperperiod( const McTask_st *pxTasks, unsigned int uiCount );
+
+/*
+ * Returns 1 if the tasks of pxTasks mapped to iCore by piCore, plus
+ * pxCandidate if not NULL, pass the demand bound test on one core.  The test
+ * is exact for synchronous periodic tasks under preemptive EDF, and the same
+ * as the kernel test (U <= 1) for implicit deadlines.
+ */
+int iMcCoreAdmits( const McTask_st *pxTasks,
+                   const int *piCore,
+                   unsigned int uiCount,
+                   int iCore,
+                   const McTask_st *pxCandidate );
+
+/*
+ * Assigns uiCount tasks to uiCores cores, by decreasing utilization, with
+ * the given heuristic.  Returns 1 if every task was placed.
+ */
+int iMcPartition( const McTask_st *pxTasks,
+                  unsigned int uiCount,
+                  unsigned int uiCores,
+                  McHeuristic_t xHeuristic,
+                  McPartition_st *pxPartition );
+
+/*
+ * Assigns uiCount tasks to uiCores cores by decreasing utilization, first
+ * fit.  A task that fits on no core is split with C=D: on each core in turn
+ * it gets the largest piece the core admits with a deadline equal to its
+ * capacity, so the piece runs without laxity and ends exactly at its
+ * deadline.  The next piece is released there, on the next core, with what
+ * is left of the capacity and of the deadline.  The last piece that fits
+ * whole keeps the rest.  Returns 1 if every task was placed.
+ */
+int iMcPartitionSemi( const McTask_st *pxTasks,
+                      unsigned int uiCount,
+                      unsigned int uiCores,
+                      McSemiPartition_st *pxPartition );
+
+/*
+ * Runs the partitioned task set over its hyperperiod, one EDF queue per
+ * core, and fills pxStats.  Returns 1 if no deadline was missed.
+ */
+int iMcSimulatePartitioned( const McTask_st *pxTasks,
+                            unsigned int uiCount,
+                            const McPartition_st *pxPartition,
+                            McSimStats_st *pxStats );
+
+/*
+ * Runs the task set over its hyperperiod under global EDF on uiCores cores:
+ * the uiCores earliest deadlines run, a new release preempts the core with
+ * the latest deadline, and a job keeps its core while it stays selected.
+ * Fills pxStats and returns 1 if no deadline was missed (an empirical test,
+ * synchronous release is not the worst case under global EDF).
+ */
+int iMcSimulateGlobal( const McTask_st *pxTasks,
+                       unsigned int uiCount,
+                       unsigned int uiCores,
+                       McSimStats_st *pxStats );
+
+/*
+ * Runs the semi-partitioned task set, one EDF queue per core, with every
+ * piece released at its offset in the job.  The run covers the largest
+ * offset plus two hyperperiods.  A job that moves to its next piece counts
+ * as a migration.  Fills pxStats (ulJobs counts the pieces) and returns 1
+ * if no deadline was missed.
+ */
+int iMcSimulateSemi( const McSemiPartition_st *pxPartition,
+                     McSimStats_st *pxStats );
+
+#endif /* MC_EDF_H */
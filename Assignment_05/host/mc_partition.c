@@ -0,0 +1,307 @@
+/*
+ * Partitioner and per-core admission test, see mc_edf.h.
+ */
+
+/* Standard includes. */
+#include <stdlib.h>
+
+#include "mc_edf.h"
+
+/*-----------------------------------------------------------*/
+
+static uint32_t prvGcd( uint32_t ulA, uint32_t ulB )
+{
+	uint32_t ulRemainder;
+
+	while( ulB != 0 )
+	{
+		ulRemainder = ulA % ulB;
+		ulA = ulB;
+		ulB = ulRemainder;
+	}
+
+	return ulA;
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * Task indices by decreasing utilization, insertion sort on a few tens of
+ * tasks.
+ */
+static void prvSortByUtilization( const McTask_st *pxTasks, unsigned int uiCount, unsigned int *puiOrder )
+{
+	unsigned int uiIndex, uiNext;
+
+	for( uiIndex = 0; uiIndex < uiCount; uiIndex++ )
+	{
+		uiNext = uiIndex;
+
+		while( ( uiNext > 0 ) && ( ulMcUtilization( &pxTasks[ puiOrder[ uiNext - 1 ] ] ) < ulMcUtilization( &pxTasks[ uiIndex ] ) ) )
+		{
+			puiOrder[ uiNext ] = puiOrder[ uiNext - 1 ];
+			uiNext--;
+		}
+
+		puiOrder[ uiNext ] = uiIndex;
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvAddPiece( McSemiPartition_st *pxPartition, unsigned int uiTask, int iCore, uint32_t ulOffset, const McTask_st *pxPiece )
+{
+	McPiece_st *pxNew = &pxPartition->xPieces[ pxPartition->uiPieceCount++ ];
+
+	pxNew->uiTask = uiTask;
+	pxNew->iCore = iCore;
+	pxNew->ulOffset = ulOffset;
+	pxNew->xPiece = *pxPiece;
+}
+/*-----------------------------------------------------------*/
+
+uint32_t ulMcUtilization( const McTask_st *pxTask )
+{
+	return ( uint32_t ) ( ( ( ( uint64_t ) pxTask->ulCapacity * MC_UTILIZATION_SCALE ) + pxTask->ulPeriod - 1 ) / pxTask->ulPeriod );
+}
+/*-----------------------------------------------------------*/
+
+uint32_t ulMcHyperperiod( const McTask_st *pxTasks, unsigned int uiCount )
+{
+	uint64_t ullHyperperiod = 1;
+	unsigned int uiIndex;
+
+	for( uiIndex = 0; uiIndex < uiCount; uiIndex++ )
+	{
+		ullHyperperiod = ( ullHyperperiod / prvGcd( ( uint32_t ) ullHyperperiod, pxTasks[ uiIndex ].ulPeriod ) ) * pxTasks[ uiIndex ].ulPeriod;
+
+		if( ullHyperperiod > MC_MAX_HYPERPERIOD )
+		{
+			return 0;
+		}
+	}
+
+	return ( uint32_t ) ullHyperperiod;
+}
+/*-----------------------------------------------------------*/
+
+int iMcCoreAdmits( const McTask_st *pxTasks,
+                   const int *piCore,
+                   unsigned int uiCount,
+                   int iCore,
+                   const McTask_st *pxCandidate )
+{
+	McTask_st xCoreTasks[ MC_MAX_TASKS + 1 ];
+	unsigned int uiCoreCount = 0, uiIndex;
+	uint32_t ulHyperperiod, ulTime;
+	uint64_t ullDemand;
+	int iConstrained = 0;
+
+	for( uiIndex = 0; uiIndex < uiCount; uiIndex++ )
+	{
+		if( piCore[ uiIndex ] == iCore )
+		{
+			xCoreTasks[ uiCoreCount++ ] = pxTasks[ uiIndex ];
+		}
+	}
+
+	if( pxCandidate != NULL )
+	{
+		xCoreTasks[ uiCoreCount++ ] = *pxCandidate;
+	}
+
+	ulHyperperiod = ulMcHyperperiod( xCoreTasks, uiCoreCount );
+
+	if( ulHyperperiod == 0 )
+	{
+		// Cannot be checked, stay on the safe side
+		return 0;
+	}
+
+	// Exact U <= 1: the work of one hyperperiod fits in it
+	ullDemand = 0;
+
+	for( uiIndex = 0; uiIndex < uiCoreCount; uiIndex++ )
+	{
+		ullDemand += ( uint64_t ) xCoreTasks[ uiIndex ].ulCapacity * ( ulHyperperiod / xCoreTasks[ uiIndex ].ulPeriod );
+		iConstrained |= ( xCoreTasks[ uiIndex ].ulDeadline < xCoreTasks[ uiIndex ].ulPeriod );
+	}
+
+	if( ullDemand > ulHyperperiod )
+	{
+		return 0;
+	}
+
+	// With implicit deadlines that is the whole test
+	if( !iConstrained )
+	{
+		return 1;
+	}
+
+	// Demand bound function at every instant of the hyperperiod
+	for( ulTime = 1; ulTime <= ulHyperperiod; ulTime++ )
+	{
+		ullDemand = 0;
+
+		for( uiIndex = 0; uiIndex < uiCoreCount; uiIndex++ )
+		{
+			if( ulTime >= xCoreTasks[ uiIndex ].ulDeadline )
+			{
+				ullDemand += ( uint64_t ) ( ( ( ulTime - xCoreTasks[ uiIndex ].ulDeadline ) / xCoreTasks[ uiIndex ].ulPeriod ) + 1 ) * xCoreTasks[ uiIndex ].ulCapacity;
+			}
+		}
+
+		if( ullDemand > ulTime )
+		{
+			return 0;
+		}
+	}
+
+	return 1;
+}
+/*-----------------------------------------------------------*/
+
+int iMcPartition( const McTask_st *pxTasks,
+                  unsigned int uiCount,
+                  unsigned int uiCores,
+                  McHeuristic_t xHeuristic,
+                  McPartition_st *pxPartition )
+{
+	unsigned int uiOrder[ MC_MAX_TASKS ];
+	uint32_t ulCoreLoad[ MC_MAX_CORES ] = { 0 };
+	unsigned int uiIndex, uiTask;
+	int iCore, iBest, iPlaced = 1;
+
+	pxPartition->uiCoreCount = uiCores;
+	prvSortByUtilization( pxTasks, uiCount, uiOrder );
+
+	for( uiIndex = 0; uiIndex < uiCount; uiIndex++ )
+	{
+		pxPartition->iCore[ uiIndex ] = -1;
+	}
+
+	for( uiIndex = 0; uiIndex < uiCount; uiIndex++ )
+	{
+		uiTask = uiOrder[ uiIndex ];
+		iBest = -1;
+
+		for( iCore = 0; iCore < ( int ) uiCores; iCore++ )
+		{
+			if( ( iBest >= 0 ) && ( ( xHeuristic == MC_FIRST_FIT ) || ( ulCoreLoad[ iCore ] >= ulCoreLoad[ iBest ] ) ) )
+			{
+				continue;
+			}
+
+			if( iMcCoreAdmits( pxTasks, pxPartition->iCore, uiCount, iCore, &pxTasks[ uiTask ] ) )
+			{
+				iBest = iCore;
+			}
+		}
+
+		if( iBest < 0 )
+		{
+			iPlaced = 0;
+			continue;
+		}
+
+		pxPartition->iCore[ uiTask ] = iBest;
+		ulCoreLoad[ iBest ] += ulMcUtilization( &pxTasks[ uiTask ] );
+	}
+
+	return iPlaced;
+}
+/*-----------------------------------------------------------*/
+
+int iMcPartitionSemi( const McTask_st *pxTasks,
+                      unsigned int uiCount,
+                      unsigned int uiCores,
+                      McSemiPartition_st *pxPartition )
+{
+	McTask_st xPieces[ MC_MAX_PIECES ], xCandidate;
+	int iPieceCores[ MC_MAX_PIECES ];
+	unsigned int uiOrder[ MC_MAX_TASKS ];
+	unsigned int uiIndex, uiTask, uiPieceCount = 0, uiFirstPiece;
+	uint32_t ulLeft, ulOffset, ulLow, ulHigh, ulMiddle;
+	int iCore;
+
+	pxPartition->uiCoreCount = uiCores;
+	pxPartition->uiPieceCount = 0;
+	pxPartition->uiSplitCount = 0;
+	prvSortByUtilization( pxTasks, uiCount, uiOrder );
+
+	for( uiIndex = 0; uiIndex < uiCount; uiIndex++ )
+	{
+		uiTask = uiOrder[ uiIndex ];
+		uiFirstPiece = uiPieceCount;
+		ulLeft = pxTasks[ uiTask ].ulCapacity;
+		ulOffset = 0;
+
+		// First fit of the whole task, as iMcPartition()
+		for( iCore = 0; ( iCore < ( int ) uiCores ) && ( uiPieceCount < MC_MAX_PIECES ); iCore++ )
+		{
+			if( iMcCoreAdmits( xPieces, iPieceCores, uiPieceCount, iCore, &pxTasks[ uiTask ] ) )
+			{
+				prvAddPiece( pxPartition, uiTask, iCore, 0, &pxTasks[ uiTask ] );
+				xPieces[ uiPieceCount ] = pxTasks[ uiTask ];
+				iPieceCores[ uiPieceCount ] = iCore;
+				uiPieceCount++;
+				ulLeft = 0;
+				break;
+			}
+		}
+
+		// Else each core takes the whole rest, or the largest zero-laxity piece it admits
+		for( iCore = 0; ( iCore < ( int ) uiCores ) && ( ulLeft > 0 ) && ( uiPieceCount < MC_MAX_PIECES ); iCore++ )
+		{
+			xCandidate.ulPeriod = pxTasks[ uiTask ].ulPeriod;
+			xCandidate.ulDeadline = pxTasks[ uiTask ].ulDeadline - ulOffset;
+			xCandidate.ulCapacity = ulLeft;
+
+			if( !iMcCoreAdmits( xPieces, iPieceCores, uiPieceCount, iCore, &xCandidate ) )
+			{
+				// Largest C = D the core still admits, below the rest
+				ulLow = 0;
+				ulHigh = ulLeft - 1;
+
+				while( ulLow < ulHigh )
+				{
+					ulMiddle = ( ulLow + ulHigh + 1 ) / 2;
+					xCandidate.ulDeadline = ulMiddle;
+					xCandidate.ulCapacity = ulMiddle;
+
+					if( iMcCoreAdmits( xPieces, iPieceCores, uiPieceCount, iCore, &xCandidate ) )
+					{
+						ulLow = ulMiddle;
+					}
+					else
+					{
+						ulHigh = ulMiddle - 1;
+					}
+				}
+
+				if( ulLow == 0 )
+				{
+					continue;
+				}
+
+				xCandidate.ulDeadline = ulLow;
+				xCandidate.ulCapacity = ulLow;
+			}
+
+			prvAddPiece( pxPartition, uiTask, iCore, ulOffset, &xCandidate );
+			xPieces[ uiPieceCount ] = xCandidate;
+			iPieceCores[ uiPieceCount ] = iCore;
+			uiPieceCount++;
+
+			ulOffset += xCandidate.ulCapacity;
+			ulLeft -= xCandidate.ulCapacity;
+		}
+
+		if( ulLeft > 0 )
+		{
+			return 0;
+		}
+
+		pxPartition->uiSplitCount += ( ( uiPieceCount - uiFirstPiece ) > 1 );
+	}
+
+	return 1;
+}
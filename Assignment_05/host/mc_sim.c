@@ -0,0 +1,351 @@
+/*
+ * Tick-by-tick multicore EDF simulator, see mc_edf.h.
+ */
+
+/* Standard includes. */
+#include <string.h>
+
+#include "mc_edf.h"
+
+// Type definitions
+typedef struct
+{
+	uint32_t ulRemaining; // Work left in the current job, 0 when idle
+	uint32_t ulDeadline; // Absolute deadline of the current job
+	int iLastCore; // Core the job last ran on, -1 if it has not run yet
+} McJob_st;
+
+// Prototypes
+static void prvMcReleaseJobs( const McTask_st *pxTasks, unsigned int uiCount, McJob_st *pxJobs, uint32_t ulTime, McSimStats_st *pxStats );
+static void prvMcRun( McJob_st *pxJob, int iCore, int *piRunning, unsigned int uiTask, McSimStats_st *pxStats );
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Drops the jobs that reached their deadline unfinished, then releases the
+ * jobs of the tasks whose period starts at ulTime.
+ */
+static void prvMcReleaseJobs( const McTask_st *pxTasks, unsigned int uiCount, McJob_st *pxJobs, uint32_t ulTime, McSimStats_st *pxStats )
+{
+	unsigned int uiTask;
+
+	for( uiTask = 0; uiTask < uiCount; uiTask++ )
+	{
+		if( ( pxJobs[ uiTask ].ulRemaining > 0 ) && ( ulTime >= pxJobs[ uiTask ].ulDeadline ) )
+		{
+			pxStats->ulMisses++;
+			pxJobs[ uiTask ].ulRemaining = 0;
+		}
+
+		if( ( ulTime % pxTasks[ uiTask ].ulPeriod ) == 0 )
+		{
+			pxJobs[ uiTask ].ulRemaining = pxTasks[ uiTask ].ulCapacity;
+			pxJobs[ uiTask ].ulDeadline = ulTime + pxTasks[ uiTask ].ulDeadline;
+			pxJobs[ uiTask ].iLastCore = -1;
+			pxStats->ulJobs++;
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * Runs uiTask for one tick on iCore, piRunning holds the task each core ran
+ * on the previous tick.
+ */
+static void prvMcRun( McJob_st *pxJob, int iCore, int *piRunning, unsigned int uiTask, McSimStats_st *pxStats )
+{
+	if( ( pxJob->iLastCore >= 0 ) && ( pxJob->iLastCore != iCore ) )
+	{
+		pxStats->ulMigrations++;
+	}
+
+	pxJob->iLastCore = iCore;
+	pxJob->ulRemaining--;
+	piRunning[ iCore ] = ( int ) uiTask;
+}
+/*-----------------------------------------------------------*/
+
+int iMcSimulatePartitioned( const McTask_st *pxTasks,
+                            unsigned int uiCount,
+                            const McPartition_st *pxPartition,
+                            McSimStats_st *pxStats )
+{
+	McJob_st xJobs[ MC_MAX_TASKS ];
+	int iRunning[ MC_MAX_CORES ];
+	uint32_t ulHyperperiod = ulMcHyperperiod( pxTasks, uiCount ), ulTime;
+	unsigned int uiTask;
+	int iCore, iEarliest;
+
+	memset( pxStats, 0, sizeof( *pxStats ) );
+	memset( xJobs, 0, sizeof( xJobs ) );
+
+	for( iCore = 0; iCore < MC_MAX_CORES; iCore++ )
+	{
+		iRunning[ iCore ] = -1;
+	}
+
+	// The hyperperiod (plus the last deadlines) repeats forever from a synchronous release
+	for( ulTime = 0; ulTime <= ulHyperperiod; ulTime++ )
+	{
+		prvMcReleaseJobs( pxTasks, uiCount, xJobs, ulTime, pxStats );
+
+		if( ulTime == ulHyperperiod )
+		{
+			break;
+		}
+
+		for( iCore = 0; iCore < ( int ) pxPartition->uiCoreCount; iCore++ )
+		{
+			iEarliest = -1;
+
+			for( uiTask = 0; uiTask < uiCount; uiTask++ )
+			{
+				if( ( pxPartition->iCore[ uiTask ] == iCore ) && ( xJobs[ uiTask ].ulRemaining > 0 ) &&
+					( ( iEarliest < 0 ) || ( xJobs[ uiTask ].ulDeadline < xJobs[ iEarliest ].ulDeadline ) ) )
+				{
+					iEarliest = ( int ) uiTask;
+				}
+			}
+
+			// The job that ran here last tick is not finished and not picked
+			if( ( iRunning[ iCore ] >= 0 ) && ( iRunning[ iCore ] != iEarliest ) &&
+				( xJobs[ iRunning[ iCore ] ].ulRemaining > 0 ) && ( xJobs[ iRunning[ iCore ] ].iLastCore == iCore ) )
+			{
+				pxStats->ulPreemptions++;
+			}
+
+			iRunning[ iCore ] = -1;
+
+			if( iEarliest >= 0 )
+			{
+				prvMcRun( &xJobs[ iEarliest ], iCore, iRunning, ( unsigned int ) iEarliest, pxStats );
+			}
+		}
+	}
+
+	return pxStats->ulMisses == 0;
+}
+/*-----------------------------------------------------------*/
+
+int iMcSimulateGlobal( const McTask_st *pxTasks,
+                       unsigned int uiCount,
+                       unsigned int uiCores,
+                       McSimStats_st *pxStats )
+{
+	McJob_st xJobs[ MC_MAX_TASKS ];
+	int iRunning[ MC_MAX_CORES ];
+	int iSelected[ MC_MAX_TASKS ];
+	uint32_t ulHyperperiod = ulMcHyperperiod( pxTasks, uiCount ), ulTime;
+	unsigned long ulJobsBefore, ulAccesses[ MC_MAX_CORES ], ulTickAccesses;
+	unsigned int uiTask, uiPicked, uiAccessingCores;
+	int iCore, iEarliest;
+
+	memset( pxStats, 0, sizeof( *pxStats ) );
+	memset( xJobs, 0, sizeof( xJobs ) );
+
+	for( iCore = 0; iCore < MC_MAX_CORES; iCore++ )
+	{
+		iRunning[ iCore ] = -1;
+	}
+
+	for( ulTime = 0; ulTime <= ulHyperperiod; ulTime++ )
+	{
+		// Every release is an insert in the shared queue, made by the core taking the tick
+		memset( ulAccesses, 0, sizeof( ulAccesses ) );
+		ulJobsBefore = pxStats->ulJobs;
+		prvMcReleaseJobs( pxTasks, uiCount, xJobs, ulTime, pxStats );
+		ulAccesses[ 0 ] = pxStats->ulJobs - ulJobsBefore;
+
+		if( ulTime == ulHyperperiod )
+		{
+			break;
+		}
+
+		// The uiCores earliest deadlines
+		memset( iSelected, 0, sizeof( iSelected ) );
+
+		for( uiPicked = 0; uiPicked < uiCores; uiPicked++ )
+		{
+			iEarliest = -1;
+
+			for( uiTask = 0; uiTask < uiCount; uiTask++ )
+			{
+				if( ( xJobs[ uiTask ].ulRemaining > 0 ) && !iSelected[ uiTask ] &&
+					( ( iEarliest < 0 ) || ( xJobs[ uiTask ].ulDeadline < xJobs[ iEarliest ].ulDeadline ) ) )
+				{
+					iEarliest = ( int ) uiTask;
+				}
+			}
+
+			if( iEarliest < 0 )
+			{
+				break;
+			}
+
+			iSelected[ iEarliest ] = 1;
+		}
+
+		// A selected job keeps its core, a preempted one goes back in the queue
+		for( iCore = 0; iCore < ( int ) uiCores; iCore++ )
+		{
+			if( iRunning[ iCore ] < 0 )
+			{
+				continue;
+			}
+
+			if( iSelected[ iRunning[ iCore ] ] && ( xJobs[ iRunning[ iCore ] ].iLastCore == iCore ) )
+			{
+				iSelected[ iRunning[ iCore ] ] = 0;
+				prvMcRun( &xJobs[ iRunning[ iCore ] ], iCore, iRunning, ( unsigned int ) iRunning[ iCore ], pxStats );
+				continue;
+			}
+
+			if( ( xJobs[ iRunning[ iCore ] ].ulRemaining > 0 ) && ( xJobs[ iRunning[ iCore ] ].iLastCore == iCore ) )
+			{
+				pxStats->ulPreemptions++;
+				ulAccesses[ iCore ]++;
+			}
+
+			iRunning[ iCore ] = -1;
+		}
+
+		// The other selected jobs are taken from the queue, back to their last core if it is free
+		for( uiTask = 0; uiTask < uiCount; uiTask++ )
+		{
+			if( !iSelected[ uiTask ] )
+			{
+				continue;
+			}
+
+			iCore = xJobs[ uiTask ].iLastCore;
+
+			if( ( iCore < 0 ) || ( iRunning[ iCore ] >= 0 ) )
+			{
+				// There is one, fewer jobs than cores are selected
+				iCore = 0;
+
+				while( iRunning[ iCore ] >= 0 )
+				{
+					iCore++;
+				}
+			}
+
+			prvMcRun( &xJobs[ uiTask ], iCore, iRunning, uiTask, pxStats );
+			ulAccesses[ iCore ]++;
+		}
+
+		ulTickAccesses = 0;
+		uiAccessingCores = 0;
+
+		for( iCore = 0; iCore < ( int ) uiCores; iCore++ )
+		{
+			ulTickAccesses += ulAccesses[ iCore ];
+			uiAccessingCores += ( ulAccesses[ iCore ] > 0 );
+		}
+
+		pxStats->ulQueueAccesses += ulTickAccesses;
+
+		// Several cores on the lock in the same tick
+		if( uiAccessingCores > 1 )
+		{
+			pxStats->ulQueueConflicts += ulTickAccesses;
+		}
+	}
+
+	return pxStats->ulMisses == 0;
+}
+/*-----------------------------------------------------------*/
+
+int iMcSimulateSemi( const McSemiPartition_st *pxPartition,
+                     McSimStats_st *pxStats )
+{
+	McTask_st xPieces[ MC_MAX_PIECES ];
+	McJob_st xJobs[ MC_MAX_PIECES ];
+	int iRunning[ MC_MAX_CORES ];
+	uint32_t ulHyperperiod, ulLastOffset = 0, ulEnd, ulTime;
+	unsigned int uiPiece, uiCount = pxPartition->uiPieceCount;
+	int iCore, iEarliest;
+
+	memset( pxStats, 0, sizeof( *pxStats ) );
+	memset( xJobs, 0, sizeof( xJobs ) );
+
+	for( uiPiece = 0; uiPiece < uiCount; uiPiece++ )
+	{
+		xPieces[ uiPiece ] = pxPartition->xPieces[ uiPiece ].xPiece;
+
+		if( pxPartition->xPieces[ uiPiece ].ulOffset > ulLastOffset )
+		{
+			ulLastOffset = pxPartition->xPieces[ uiPiece ].ulOffset;
+		}
+	}
+
+	for( iCore = 0; iCore < MC_MAX_CORES; iCore++ )
+	{
+		iRunning[ iCore ] = -1;
+	}
+
+	// Past the largest offset the schedule repeats every hyperperiod
+	ulHyperperiod = ulMcHyperperiod( xPieces, uiCount );
+	ulEnd = ulLastOffset + ( 2 * ulHyperperiod );
+
+	for( ulTime = 0; ulTime <= ulEnd; ulTime++ )
+	{
+		for( uiPiece = 0; uiPiece < uiCount; uiPiece++ )
+		{
+			if( ( xJobs[ uiPiece ].ulRemaining > 0 ) && ( ulTime >= xJobs[ uiPiece ].ulDeadline ) )
+			{
+				pxStats->ulMisses++;
+				xJobs[ uiPiece ].ulRemaining = 0;
+			}
+
+			if( ( ulTime >= pxPartition->xPieces[ uiPiece ].ulOffset ) &&
+				( ( ( ulTime - pxPartition->xPieces[ uiPiece ].ulOffset ) % xPieces[ uiPiece ].ulPeriod ) == 0 ) )
+			{
+				xJobs[ uiPiece ].ulRemaining = xPieces[ uiPiece ].ulCapacity;
+				xJobs[ uiPiece ].ulDeadline = ulTime + xPieces[ uiPiece ].ulDeadline;
+				xJobs[ uiPiece ].iLastCore = -1;
+				pxStats->ulJobs++;
+
+				// The job goes on with its next piece on another core
+				if( pxPartition->xPieces[ uiPiece ].ulOffset > 0 )
+				{
+					pxStats->ulMigrations++;
+				}
+			}
+		}
+
+		if( ulTime == ulEnd )
+		{
+			break;
+		}
+
+		for( iCore = 0; iCore < ( int ) pxPartition->uiCoreCount; iCore++ )
+		{
+			iEarliest = -1;
+
+			for( uiPiece = 0; uiPiece < uiCount; uiPiece++ )
+			{
+				if( ( pxPartition->xPieces[ uiPiece ].iCore == iCore ) && ( xJobs[ uiPiece ].ulRemaining > 0 ) &&
+					( ( iEarliest < 0 ) || ( xJobs[ uiPiece ].ulDeadline < xJobs[ iEarliest ].ulDeadline ) ) )
+				{
+					iEarliest = ( int ) uiPiece;
+				}
+			}
+
+			if( ( iRunning[ iCore ] >= 0 ) && ( iRunning[ iCore ] != iEarliest ) &&
+				( xJobs[ iRunning[ iCore ] ].ulRemaining > 0 ) && ( xJobs[ iRunning[ iCore ] ].iLastCore == iCore ) )
+			{
+				pxStats->ulPreemptions++;
+			}
+
+			iRunning[ iCore ] = -1;
+
+			if( iEarliest >= 0 )
+			{
+				prvMcRun( &xJobs[ iEarliest ], iCore, iRunning, ( unsigned int ) iEarliest, pxStats );
+			}
+		}
+	}
+
+	return pxStats->ulMisses == 0;
+}
@@ -0,0 +1,281 @@
+/*
+ * Cache lines touched per scheduling decision by the two TCB layouts of
+ * tasks.c (configEDF_HOT_TCB_LAYOUT 0 and 1).
+ *
+ * The LPC2138 has no data cache, so this is counted on a model instead of
+ * measured: the two structs below mirror tskTCB for the FreeRTOSConfig.h of
+ * this assignment compiled for a 32-bit core (pointers, ticks and
+ * UBaseType_t on 4 bytes), and keep the field order of tasks.c.  Every
+ * decision reads a known set of fields in a known number of TCBs; TCBs sit
+ * far apart (each one next to its stack) and start on any 8-byte boundary
+ * (portBYTE_ALIGNMENT), so the benchmark counts the distinct lines of each
+ * TCB read and averages over the start offsets in a line.  The last column
+ * starts every hot TCB on a line, as a line-aligned heap or linker section
+ * would.  A cold cache misses once per line.
+ *
+ * The insert walk is also counted with the deadlines held in a separate
+ * array of keys (a struct-of-arrays ready queue), which tasks.c does not
+ * implement: it shows what is left to gain after the hot layout.
+ *
+ * Build and run from this directory:
+ *
+ *     gcc -O2 -o tcb_layout tcb_layout.c
+ *     ./tcb_layout
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Type definitions
+typedef struct
+{
+	uint32_t xItemValue;
+	uint32_t pxNext;
+	uint32_t pxPrevious;
+	uint32_t pvOwner;
+	uint32_t pxContainer;
+} TargetListItem_st;
+
+// Fields after xEventListItem, the same in both layouts
+#define TCB_COLD_FIELDS \
+	TargetListItem_st xEventListItem; \
+	uint32_t uxPriority; \
+	uint32_t pxStack; \
+	char pcTaskName[ 8 ]; \
+	uint32_t pxTaskTag; \
+	uint32_t ulNotifiedValue[ 1 ]; \
+	uint8_t ucNotifyState[ 1 ]; \
+	uint8_t ucStaticallyAllocated;
+
+typedef struct
+{
+	uint32_t pxTopOfStack;
+	uint32_t uxStrideTickets;
+	uint32_t xStride;
+	uint32_t xStridePass;
+	uint32_t uxStrideEpoch;
+	uint32_t xTaskMaxNPR;
+	uint32_t uxNPRNesting;
+	uint32_t xNPRTicks;
+	uint32_t xTaskPeriod;
+	uint32_t xTaskDeadline;
+	uint32_t xTaskCapacity;
+	uint32_t xJobDeadline;
+	uint8_t ucPeriodicState;
+	TargetListItem_st xStateListItem;
+	TCB_COLD_FIELDS
+} DefaultTCB_st;
+
+typedef struct
+{
+	uint32_t pxTopOfStack;
+	TargetListItem_st xStateListItem;
+	uint32_t uxStrideTickets;
+	uint32_t xStride;
+	uint32_t xStridePass;
+	uint32_t uxStrideEpoch;
+	uint32_t xTaskMaxNPR;
+	uint32_t uxNPRNesting;
+	uint32_t xNPRTicks;
+	uint32_t xTaskPeriod;
+	uint32_t xTaskDeadline;
+	uint32_t xTaskCapacity;
+	uint32_t xJobDeadline;
+	uint8_t ucPeriodicState;
+	TCB_COLD_FIELDS
+} HotTCB_st;
+
+// Field of a TCB, offset and size in both layouts
+typedef struct
+{
+	size_t xOffset[ 2 ];
+	size_t xSize;
+} TcbField_st;
+
+#define TCB_FIELD( field ) \
+	{ { offsetof( DefaultTCB_st, field ), offsetof( HotTCB_st, field ) }, sizeof( ( ( HotTCB_st * ) 0 )->field ) }
+
+// Fields read by one decision in one TCB
+typedef struct
+{
+	const char *pcName;
+	const TcbField_st *pxFields;
+	unsigned int uiCount;
+} TcbAccess_st;
+
+// Global Variables
+
+// vListInsert() and prvEDFRunsBefore() on every task an insert walks past
+static const TcbField_st xWalkFields[] =
+{
+	TCB_FIELD( xStateListItem.xItemValue ),
+	TCB_FIELD( xStateListItem.pxNext ),
+	TCB_FIELD( uxStrideTickets )
+};
+
+// xTaskIncrementTick() moving a job from the delayed list to the ready list
+static const TcbField_st xReleaseFields[] =
+{
+	TCB_FIELD( xStateListItem ),
+	TCB_FIELD( xEventListItem.pxContainer ),
+	TCB_FIELD( ucPeriodicState ),
+	TCB_FIELD( xTaskDeadline ),
+	TCB_FIELD( uxStrideTickets )
+};
+
+// xTaskIncrementTick() on the running task: deadline, region and pass
+static const TcbField_st xTickFields[] =
+{
+	TCB_FIELD( xStateListItem.xItemValue ),
+	TCB_FIELD( uxStrideTickets ),
+	TCB_FIELD( xStride ),
+	TCB_FIELD( xStridePass ),
+	TCB_FIELD( xTaskMaxNPR ),
+	TCB_FIELD( uxNPRNesting ),
+	TCB_FIELD( xNPRTicks )
+};
+
+// vTaskSwitchContext() and the port on the task switched in, with the trace tag of FreeRTOSConfig.h
+static const TcbField_st xSwitchFields[] =
+{
+	TCB_FIELD( pxTopOfStack ),
+	TCB_FIELD( xStateListItem.pvOwner ),
+	TCB_FIELD( xStateListItem.pxNext ),
+	TCB_FIELD( pxTaskTag )
+};
+
+// prvEDFAdmissionTest() on every registered task
+static const TcbField_st xAdmissionFields[] =
+{
+	TCB_FIELD( xTaskPeriod ),
+	TCB_FIELD( xTaskDeadline ),
+	TCB_FIELD( xTaskCapacity )
+};
+
+#define TCB_ACCESS( name, fields ) { name, fields, sizeof( fields ) / sizeof( fields[ 0 ] ) }
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Lines of one TCB read by an access, averaged over the starts of the TCB in
+ * a line that are multiples of xAlignment.
+ */
+static double prvLinesPerTcb( const TcbAccess_st *pxAccess, unsigned int uiLayout, size_t xLine, size_t xAlignment )
+{
+	unsigned char ucTouched[ 512 ];
+	size_t xStart, xByte, xLines = 0, xFirst, xLast;
+	unsigned int uiField;
+
+	for( xStart = 0; xStart < xLine; xStart += xAlignment )
+	{
+		for( xByte = 0; xByte < sizeof( ucTouched ); xByte++ )
+		{
+			ucTouched[ xByte ] = 0;
+		}
+
+		for( uiField = 0; uiField < pxAccess->uiCount; uiField++ )
+		{
+			xFirst = ( xStart + pxAccess->pxFields[ uiField ].xOffset[ uiLayout ] ) / xLine;
+			xLast = ( xStart + pxAccess->pxFields[ uiField ].xOffset[ uiLayout ] + pxAccess->pxFields[ uiField ].xSize - 1 ) / xLine;
+
+			for( xByte = xFirst; xByte <= xLast; xByte++ )
+			{
+				ucTouched[ xByte ] = 1;
+			}
+		}
+
+		for( xByte = 0; xByte < sizeof( ucTouched ); xByte++ )
+		{
+			xLines += ucTouched[ xByte ];
+		}
+	}
+
+	return ( double ) xLines / ( xLine / xAlignment );
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * Lines of a key array read by a walk past uiVisited keys of 4 bytes,
+ * averaged over the 4-byte aligned starts in a line.
+ */
+static double prvLinesPerKeyWalk( unsigned int uiVisited, size_t xLine )
+{
+	size_t xStart, xLines = 0;
+
+	if( uiVisited == 0 )
+	{
+		return 0.0;
+	}
+
+	for( xStart = 0; xStart < xLine; xStart += 4 )
+	{
+		xLines += ( ( xStart + ( 4 * uiVisited ) - 1 ) / xLine ) + 1;
+	}
+
+	return ( double ) xLines / ( xLine / 4 );
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * Prints one line of the per-TCB table: default and hot layouts on 8-byte
+ * boundaries, then hot on a line boundary.
+ */
+static void prvPrintAccess( const TcbAccess_st *pxAccess, size_t xLine )
+{
+	printf( "%-9s  %8.2f  %5.2f  %11.2f\n", pxAccess->pcName,
+			prvLinesPerTcb( pxAccess, 0, xLine, 8 ), prvLinesPerTcb( pxAccess, 1, xLine, 8 ), prvLinesPerTcb( pxAccess, 1, xLine, xLine ) );
+}
+/*-----------------------------------------------------------*/
+
+int main( void )
+{
+	static const size_t xLines[] = { 32, 64 };
+	static const unsigned int uiTasks[] = { 4, 8, 16, 32 };
+	const TcbAccess_st xWalk = TCB_ACCESS( "walk", xWalkFields );
+	const TcbAccess_st xRelease = TCB_ACCESS( "release", xReleaseFields );
+	const TcbAccess_st xAccesses[] =
+	{
+		TCB_ACCESS( "tick", xTickFields ),
+		TCB_ACCESS( "switch", xSwitchFields ),
+		TCB_ACCESS( "admission", xAdmissionFields )
+	};
+	double dDefault, dHot, dAligned, dKeys;
+	unsigned int uiLine, uiTask, uiAccess, uiVisited;
+	size_t xLine;
+
+	printf( "TCB size: default %u bytes, hot %u bytes\n\n", ( unsigned int ) sizeof( DefaultTCB_st ), ( unsigned int ) sizeof( HotTCB_st ) );
+
+	for( uiLine = 0; uiLine < sizeof( xLines ) / sizeof( xLines[ 0 ] ); uiLine++ )
+	{
+		xLine = xLines[ uiLine ];
+		printf( "%u-byte lines, lines per TCB\n", ( unsigned int ) xLine );
+		printf( "access      default    hot  hot aligned\n" );
+		prvPrintAccess( &xWalk, xLine );
+		prvPrintAccess( &xRelease, xLine );
+
+		for( uiAccess = 0; uiAccess < sizeof( xAccesses ) / sizeof( xAccesses[ 0 ] ); uiAccess++ )
+		{
+			prvPrintAccess( &xAccesses[ uiAccess ], xLine );
+		}
+
+		// A release walks past half of the ready tasks on average
+		printf( "\n%u-byte lines, misses per release into a ready list of n tasks\n", ( unsigned int ) xLine );
+		printf( "    n   default     hot  hot aligned  hot aligned + key array\n" );
+
+		for( uiTask = 0; uiTask < sizeof( uiTasks ) / sizeof( uiTasks[ 0 ] ); uiTask++ )
+		{
+			uiVisited = uiTasks[ uiTask ] / 2;
+			dDefault = prvLinesPerTcb( &xRelease, 0, xLine, 8 ) + ( uiVisited * prvLinesPerTcb( &xWalk, 0, xLine, 8 ) );
+			dHot = prvLinesPerTcb( &xRelease, 1, xLine, 8 ) + ( uiVisited * prvLinesPerTcb( &xWalk, 1, xLine, 8 ) );
+			dAligned = prvLinesPerTcb( &xRelease, 1, xLine, xLine ) + ( uiVisited * prvLinesPerTcb( &xWalk, 1, xLine, xLine ) );
+			dKeys = prvLinesPerTcb( &xRelease, 1, xLine, xLine ) + prvLinesPerKeyWalk( uiVisited, xLine );
+			printf( "%5u  %8.2f  %6.2f  %11.2f  %23.2f\n", uiTasks[ uiTask ], dDefault, dHot, dAligned, dKeys );
+		}
+
+		printf( "\n" );
+	}
+
+	return 0;
+}
@@ -0,0 +1,252 @@
+/*
+ * Kernel overhead accounting, see kernel_stats.h.
+ */
+
+/* Scheduler includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "lpc21xx.h"
+
+#include "kernel_stats.h"
+
+// Global Variables
+static KernelPathStats_st xKernelPaths[ KERNEL_PATH_COUNT ];
+static KernelSection_st xKernelLongest[ KERNEL_STATS_LONGEST ];
+static uint32_t ulKernelTickStart = 0;
+static uint32_t ulKernelSwitchStart = 0;
+static uint32_t ulKernelHooksStart = 0;
+static uint32_t ulKernelCriticalStart = 0;
+static uint32_t ulKernelCriticalLine = 0;
+static UBaseType_t uxKernelCriticalNesting = 0; // Outermost section open when above 0
+static volatile uint32_t ulKernelTotal = 0; // Timer1 counts in the tick, the switch and the critical sections
+static uint32_t ulKernelTotalCycles = 0; // Cycles not making a whole count yet
+
+// Prototypes
+static void prvKernelRecord( KernelPath_t xPath, uint32_t ulStart, uint32_t ulSite );
+static void prvKernelRecordLongest( uint32_t ulCycles, uint32_t ulSite );
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Adds the duration from ulStart to now to the path, and to the longest
+ * windows when ulSite is not 0.
+ */
+static void prvKernelRecord( KernelPath_t xPath, uint32_t ulStart, uint32_t ulSite )
+{
+	KernelPathStats_st *pxPath = &xKernelPaths[ xPath ];
+	uint32_t ulCycles = ulKernelStatsNow() - ulStart, ulScaled;
+	UBaseType_t uxBucket = 0;
+
+	if( ( pxPath->ulCount == 0 ) || ( ulCycles < pxPath->ulMin ) )
+	{
+		pxPath->ulMin = ulCycles;
+	}
+
+	if( ulCycles > pxPath->ulMax )
+	{
+		pxPath->ulMax = ulCycles;
+	}
+
+	pxPath->ulCount++;
+	pxPath->ullTotal += ulCycles;
+
+	// log2 bucket, without a division
+	for( ulScaled = ulCycles >> KERNEL_STATS_FIRST_BUCKET; ( ulScaled != 0 ) && ( uxBucket < ( KERNEL_STATS_BUCKETS - 1 ) ); ulScaled >>= 1 )
+	{
+		uxBucket++;
+	}
+
+	pxPath->ulHistogram[ uxBucket ]++;
+
+	// The hooks run inside the tick and the switch, they are not added twice
+	if( xPath != KERNEL_PATH_HOOKS )
+	{
+		ulKernelTotalCycles += ulCycles;
+
+		while( ulKernelTotalCycles > T1PR )
+		{
+			ulKernelTotalCycles -= T1PR + 1UL;
+			ulKernelTotal++;
+		}
+	}
+
+	if( ulSite != 0 )
+	{
+		prvKernelRecordLongest( ulCycles, ulSite );
+	}
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * Keeps the window if it is longer than the shortest one kept.
+ */
+static void prvKernelRecordLongest( uint32_t ulCycles, uint32_t ulSite )
+{
+	UBaseType_t uxSlot = KERNEL_STATS_LONGEST - 1;
+
+	if( ulCycles <= xKernelLongest[ uxSlot ].ulCycles )
+	{
+		return;
+	}
+
+	while( ( uxSlot > 0 ) && ( xKernelLongest[ uxSlot - 1 ].ulCycles < ulCycles ) )
+	{
+		xKernelLongest[ uxSlot ] = xKernelLongest[ uxSlot - 1 ];
+		uxSlot--;
+	}
+
+	xKernelLongest[ uxSlot ].ulCycles = ulCycles;
+	xKernelLongest[ uxSlot ].ulSite = ulSite;
+}
+/*-----------------------------------------------------------*/
+
+uint32_t ulKernelStatsNow( void )
+{
+	uint32_t ulCounter, ulPrescale;
+
+	// T1PC wraps into T1TC between the two reads, read again until they match
+	do
+	{
+		ulCounter = T1TC;
+		ulPrescale = T1PC;
+	} while( ulCounter != T1TC );
+
+	return ( ulCounter * ( T1PR + 1UL ) ) + ulPrescale;
+}
+/*-----------------------------------------------------------*/
+
+void vKernelStatsTickEnter( void )
+{
+	ulKernelTickStart = ulKernelStatsNow();
+}
+/*-----------------------------------------------------------*/
+
+void vKernelStatsTickExit( void )
+{
+	prvKernelRecord( KERNEL_PATH_TICK, ulKernelTickStart, KERNEL_SITE_TICK );
+}
+/*-----------------------------------------------------------*/
+
+void vKernelStatsSwitchEnter( void )
+{
+	ulKernelSwitchStart = ulKernelStatsNow();
+}
+/*-----------------------------------------------------------*/
+
+void vKernelStatsSwitchExit( void )
+{
+	prvKernelRecord( KERNEL_PATH_SWITCH, ulKernelSwitchStart, KERNEL_SITE_SWITCH );
+
+	// A task yielded inside a critical section, the task switched in has its own nesting
+	if( uxKernelCriticalNesting > 0 )
+	{
+		prvKernelRecord( KERNEL_PATH_CRITICAL, ulKernelCriticalStart, ulKernelCriticalLine );
+		uxKernelCriticalNesting = 0;
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vKernelStatsCriticalEnter( uint32_t ulLine )
+{
+	// Interrupts are disabled, the nesting cannot change under us
+	if( uxKernelCriticalNesting++ == 0 )
+	{
+		ulKernelCriticalLine = ulLine;
+		ulKernelCriticalStart = ulKernelStatsNow();
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vKernelStatsCriticalExit( void )
+{
+	// 0 after a yield inside the section, it was closed by the switch
+	if( uxKernelCriticalNesting == 0 )
+	{
+		return;
+	}
+
+	if( --uxKernelCriticalNesting == 0 )
+	{
+		prvKernelRecord( KERNEL_PATH_CRITICAL, ulKernelCriticalStart, ulKernelCriticalLine );
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vKernelStatsHooksEnter( void )
+{
+	ulKernelHooksStart = ulKernelStatsNow();
+}
+/*-----------------------------------------------------------*/
+
+void vKernelStatsHooksExit( void )
+{
+	prvKernelRecord( KERNEL_PATH_HOOKS, ulKernelHooksStart, 0 );
+}
+/*-----------------------------------------------------------*/
+
+void vKernelStatsGetPath( KernelPath_t xPath, KernelPathStats_st *pxStats )
+{
+	configASSERT( ( xPath < KERNEL_PATH_COUNT ) && ( pxStats != NULL ) );
+
+	// The tick and the switch update the figures from interrupts
+	taskENTER_CRITICAL();
+	{
+		*pxStats = xKernelPaths[ xPath ];
+	}
+	taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+void vKernelStatsGetLongest( KernelSection_st pxSections[ KERNEL_STATS_LONGEST ] )
+{
+	UBaseType_t uxSlot;
+
+	configASSERT( pxSections != NULL );
+
+	taskENTER_CRITICAL();
+	{
+		for( uxSlot = 0; uxSlot < KERNEL_STATS_LONGEST; uxSlot++ )
+		{
+			pxSections[ uxSlot ] = xKernelLongest[ uxSlot ];
+		}
+	}
+	taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+uint32_t ulKernelStatsGetTotal( void )
+{
+	return ulKernelTotal;
+}
+/*-----------------------------------------------------------*/
+
+void vKernelStatsReset( void )
+{
+	UBaseType_t uxIndex, uxBucket;
+
+	taskENTER_CRITICAL();
+	{
+		for( uxIndex = 0; uxIndex < KERNEL_PATH_COUNT; uxIndex++ )
+		{
+			xKernelPaths[ uxIndex ].ulCount = 0;
+			xKernelPaths[ uxIndex ].ulMin = 0;
+			xKernelPaths[ uxIndex ].ulMax = 0;
+			xKernelPaths[ uxIndex ].ullTotal = 0;
+
+			for( uxBucket = 0; uxBucket < KERNEL_STATS_BUCKETS; uxBucket++ )
+			{
+				xKernelPaths[ uxIndex ].ulHistogram[ uxBucket ] = 0;
+			}
+		}
+
+		for( uxIndex = 0; uxIndex < KERNEL_STATS_LONGEST; uxIndex++ )
+		{
+			xKernelLongest[ uxIndex ].ulCycles = 0;
+			xKernelLongest[ uxIndex ].ulSite = 0;
+		}
+
+		ulKernelTotal = 0;
+		ulKernelTotalCycles = 0;
+	}
+	taskEXIT_CRITICAL();
+}
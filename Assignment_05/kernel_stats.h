@@ -0,0 +1,117 @@
+/*
+ * Kernel overhead accounting.
+ *
+ * Measures the time spent in the kernel paths against Timer1, at the rate
+ * of its prescaler input (one PCLK cycle: T1TC * (T1PR + 1) + T1PC):
+ *
+ *  - the tick, xTaskIncrementTick() with the tick hook it calls,
+ *  - the context switch, vTaskSwitchContext() with the trace macros it runs,
+ *  - the critical sections of tasks.c, from taskENTER_CRITICAL() to the
+ *    outermost taskEXIT_CRITICAL(),
+ *  - the hooks, traceTASK_SWITCHED_IN(), traceTASK_SWITCHED_OUT() and
+ *    vApplicationTickHook(), also counted in the tick and the switch they
+ *    run in.
+ *
+ * Per path the module keeps the count, the minimum, the maximum, the total
+ * and a histogram of the durations.  It also keeps the KERNEL_STATS_LONGEST
+ * longest windows run with interrupts disabled, with their call site: the
+ * line of tasks.c for a critical section, KERNEL_SITE_TICK or
+ * KERNEL_SITE_SWITCH for the two paths run from the tick and yield
+ * interrupts.  A task that yields inside a critical section ends it at the
+ * end of the switch.
+ *
+ * The figures include the cost of the measurement, two Timer1 reads per
+ * path.  Requires Timer1 running and the kernel trace hooks set in
+ * FreeRTOSConfig.h, with configUSE_KERNEL_STATS set to 1.
+ */
+
+#ifndef KERNEL_STATS_H
+#define KERNEL_STATS_H
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+// Histogram buckets: below 2^KERNEL_STATS_FIRST_BUCKET cycles, then one per power of two, the last one open
+#ifndef KERNEL_STATS_BUCKETS
+#define KERNEL_STATS_BUCKETS 8
+#endif
+
+#ifndef KERNEL_STATS_FIRST_BUCKET
+#define KERNEL_STATS_FIRST_BUCKET 6 // 64 cycles, about 1 us at 60 MHz
+#endif
+
+// Longest interrupts-disabled windows kept
+#ifndef KERNEL_STATS_LONGEST
+#define KERNEL_STATS_LONGEST 4
+#endif
+
+// Call sites of the windows that are not critical sections of tasks.c
+#define KERNEL_SITE_TICK ( ( uint32_t ) 0xFFFFFFFEUL )
+#define KERNEL_SITE_SWITCH ( ( uint32_t ) 0xFFFFFFFFUL )
+
+// Type definitions
+typedef enum
+{
+	KERNEL_PATH_TICK,
+	KERNEL_PATH_SWITCH,
+	KERNEL_PATH_CRITICAL,
+	KERNEL_PATH_HOOKS,
+	KERNEL_PATH_COUNT
+} KernelPath_t;
+
+typedef struct
+{
+	uint32_t ulCount;
+	uint32_t ulMin; // In cycles, like every duration below
+	uint32_t ulMax;
+	uint64_t ullTotal;
+	uint32_t ulHistogram[ KERNEL_STATS_BUCKETS ];
+} KernelPathStats_st;
+
+typedef struct
+{
+	uint32_t ulCycles; // 0 for an unused entry
+	uint32_t ulSite; // Line of tasks.c, KERNEL_SITE_TICK or KERNEL_SITE_SWITCH
+} KernelSection_st;
+
+/*
+ * Current time in Timer1 prescaler input cycles.
+ */
+uint32_t ulKernelStatsNow( void );
+
+/*
+ * Called by the kernel trace hooks, see FreeRTOSConfig.h.
+ */
+void vKernelStatsTickEnter( void );
+void vKernelStatsTickExit( void );
+void vKernelStatsSwitchEnter( void );
+void vKernelStatsSwitchExit( void );
+void vKernelStatsCriticalEnter( uint32_t ulLine );
+void vKernelStatsCriticalExit( void );
+void vKernelStatsHooksEnter( void );
+void vKernelStatsHooksExit( void );
+
+/*
+ * Copies the figures of one path into pxStats.
+ */
+void vKernelStatsGetPath( KernelPath_t xPath, KernelPathStats_st *pxStats );
+
+/*
+ * Copies the longest interrupts-disabled windows into pxSections, longest
+ * first.
+ */
+void vKernelStatsGetLongest( KernelSection_st pxSections[ KERNEL_STATS_LONGEST ] );
+
+/*
+ * Time spent in the tick, the switch and the critical sections, in Timer1
+ * counts like the task run times of main.c.  Can be called from the tick
+ * hook.
+ */
+uint32_t ulKernelStatsGetTotal( void );
+
+/*
+ * Clears every figure, for instance after the start-up transient.
+ */
+void vKernelStatsReset( void );
+
+#endif /* KERNEL_STATS_H */
@@ -0,0 +1,173 @@
+/*
+ * CPU load monitor, see load_monitor.h.
+ */
+
+/* Scheduler includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "edf_task.h"
+#include "lpc21xx.h"
+
+#include "load_monitor.h"
+
+// Type definitions
+typedef struct
+{
+	TickType_t xLength; // Ticks per window
+	TickType_t xTicks; // Ticks elapsed in the current window
+	uint32_t ulStart; // T1TC at the start of the current window
+	uint32_t ulIdle; // Idle time in the current window, in T1TC counts
+} LoadWindow_st;
+
+// Global Variables
+static LoadWindow_st xLoadWindow = { LOAD_MONITOR_WINDOW, 0, 0, 0 };
+static LoadWindow_st xLoadHyperperiod = { 0, 0, 0, 0 };
+static uint32_t ulLoadIdleIn = 0; // T1TC when the idle task was switched in, or last charged
+static BaseType_t xLoadIdleRunning = pdFALSE;
+static uint32_t ulLoadInstant = 0;
+static uint32_t ulLoadSmoothed = 0;
+static uint32_t ulLoadHyperperiod = 0;
+
+// Prototypes
+static void prvLoadChargeIdle( uint32_t ulNow );
+static BaseType_t prvLoadWindowEnd( LoadWindow_st *pxWindow, uint32_t ulNow, uint32_t *pulLoad );
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Adds the idle time since the last charge to the open windows.
+ */
+static void prvLoadChargeIdle( uint32_t ulNow )
+{
+	uint32_t ulIdle;
+
+	if( xLoadIdleRunning != pdFALSE )
+	{
+		ulIdle = ulNow - ulLoadIdleIn;
+		xLoadWindow.ulIdle += ulIdle;
+		xLoadHyperperiod.ulIdle += ulIdle;
+		ulLoadIdleIn = ulNow;
+	}
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * Counts one tick in the window, and at its end stores its load in *pulLoad
+ * and starts the next one.  Returns pdTRUE if the window ended.
+ */
+static BaseType_t prvLoadWindowEnd( LoadWindow_st *pxWindow, uint32_t ulNow, uint32_t *pulLoad )
+{
+	uint32_t ulElapsed;
+
+	pxWindow->xTicks++;
+
+	if( pxWindow->xTicks < pxWindow->xLength )
+	{
+		return pdFALSE;
+	}
+
+	ulElapsed = ulNow - pxWindow->ulStart;
+
+	if( pxWindow->ulIdle >= ulElapsed )
+	{
+		*pulLoad = 0;
+	}
+	else
+	{
+		// 64 bit product, a long window overflows idle * scale
+		*pulLoad = LOAD_UTILIZATION_SCALE - ( uint32_t ) ( ( ( uint64_t ) pxWindow->ulIdle * LOAD_UTILIZATION_SCALE ) / ulElapsed );
+	}
+
+	pxWindow->xTicks = 0;
+	pxWindow->ulStart = ulNow;
+	pxWindow->ulIdle = 0;
+
+	return pdTRUE;
+}
+/*-----------------------------------------------------------*/
+
+void vLoadMonitorInit( TickType_t xHyperperiod )
+{
+	uint32_t ulNow = T1TC;
+
+	configASSERT( xHyperperiod > 0 );
+
+	xLoadWindow.ulStart = ulNow;
+	xLoadHyperperiod.xLength = xHyperperiod;
+	xLoadHyperperiod.ulStart = ulNow;
+}
+/*-----------------------------------------------------------*/
+
+void vLoadMonitorTickFromISR( void )
+{
+	uint32_t ulNow;
+
+	// Most ticks end no window, T1TC is only read when one does
+	if( ( ( xLoadWindow.xTicks + 1 ) < xLoadWindow.xLength ) &&
+		( ( xLoadHyperperiod.xTicks + 1 ) < xLoadHyperperiod.xLength ) )
+	{
+		xLoadWindow.xTicks++;
+		xLoadHyperperiod.xTicks++;
+		return;
+	}
+
+	// Not started yet
+	if( xLoadHyperperiod.xLength == 0 )
+	{
+		return;
+	}
+
+	ulNow = T1TC;
+
+	// The idle task may be running under the tick, its time so far goes in these windows
+	prvLoadChargeIdle( ulNow );
+
+	if( prvLoadWindowEnd( &xLoadWindow, ulNow, &ulLoadInstant ) != pdFALSE )
+	{
+		// Signed step, the average moves down as well as up
+		ulLoadSmoothed = ( uint32_t ) ( ( int32_t ) ulLoadSmoothed + ( ( ( int32_t ) ulLoadInstant - ( int32_t ) ulLoadSmoothed ) / ( 1L << LOAD_MONITOR_SMOOTHING ) ) );
+	}
+
+	( void ) prvLoadWindowEnd( &xLoadHyperperiod, ulNow, &ulLoadHyperperiod );
+}
+/*-----------------------------------------------------------*/
+
+void vLoadMonitorIdleIn( void )
+{
+	ulLoadIdleIn = T1TC;
+	xLoadIdleRunning = pdTRUE;
+}
+/*-----------------------------------------------------------*/
+
+void vLoadMonitorIdleOut( void )
+{
+	prvLoadChargeIdle( T1TC );
+	xLoadIdleRunning = pdFALSE;
+}
+/*-----------------------------------------------------------*/
+
+void vLoadMonitorGetStats( LoadStats_st *pxStats )
+{
+	configASSERT( pxStats != NULL );
+
+	// The tick hook updates the three figures together
+	taskENTER_CRITICAL();
+	{
+		pxStats->ulInstant = ulLoadInstant;
+		pxStats->ulSmoothed = ulLoadSmoothed;
+		pxStats->ulHyperperiod = ulLoadHyperperiod;
+	}
+	taskEXIT_CRITICAL();
+
+	pxStats->ulDeclared = ulTaskPeriodicGetUtilization();
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xLoadMonitorIsOverloaded( uint32_t ulMargin )
+{
+	LoadStats_st xStats;
+
+	vLoadMonitorGetStats( &xStats );
+
+	return ( xStats.ulSmoothed > ( xStats.ulDeclared + ulMargin ) ) ? pdTRUE : pdFALSE;
+}
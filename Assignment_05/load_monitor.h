@@ -0,0 +1,80 @@
+/*
+ * CPU load monitor.
+ *
+ * Measures how long the idle task runs, against Timer1 (T1TC), and turns it
+ * into a CPU utilization.  The trace hooks mark each switch in and out of the
+ * idle task, and the tick hook closes the measurement windows.  Per window
+ * the monitor keeps:
+ *
+ *  - the instantaneous load, over the last window of LOAD_MONITOR_WINDOW ticks,
+ *  - an exponentially smoothed load, updated at the end of every window,
+ *  - the load over the last hyperperiod of the periodic task set.
+ *
+ * It also keeps the declared utilization of the periodic tasks admitted by
+ * the kernel (the sum of C/T), so a measured load creeping above it can raise
+ * an alarm.  Between two windows, the cost is one comparison per context
+ * switch and one counter per tick.
+ *
+ * Requires configUSE_TICK_HOOK set to 1, with vLoadMonitorTickFromISR()
+ * called from vApplicationTickHook(), and Timer1 running.
+ */
+
+#ifndef LOAD_MONITOR_H
+#define LOAD_MONITOR_H
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+// Ticks per measurement window
+#ifndef LOAD_MONITOR_WINDOW
+#define LOAD_MONITOR_WINDOW 100
+#endif
+
+// Weight of a new window in the smoothed load, 1 / 2^LOAD_MONITOR_SMOOTHING
+#ifndef LOAD_MONITOR_SMOOTHING
+#define LOAD_MONITOR_SMOOTHING 3
+#endif
+
+// Utilization reached by 100 % of the CPU
+#define LOAD_UTILIZATION_SCALE ( ( uint32_t ) 10000UL )
+
+// Type definitions
+typedef struct
+{
+	uint32_t ulInstant; // Last window
+	uint32_t ulSmoothed; // Exponential average of the windows
+	uint32_t ulHyperperiod; // Last complete hyperperiod
+	uint32_t ulDeclared; // Sum of C/T of the admitted periodic tasks
+} LoadStats_st;
+
+/*
+ * Starts the measurements.  xHyperperiod is the least common multiple of the
+ * task periods in ticks.  Call it before the scheduler starts.
+ */
+void vLoadMonitorInit( TickType_t xHyperperiod );
+
+/*
+ * Closes the windows that end on this tick, call once per tick from the tick
+ * hook.
+ */
+void vLoadMonitorTickFromISR( void );
+
+/*
+ * Called by traceTASK_SWITCHED_IN() and traceTASK_SWITCHED_OUT() when the
+ * idle task is switched in or out.
+ */
+void vLoadMonitorIdleIn( void );
+void vLoadMonitorIdleOut( void );
+
+/*
+ * Copies the latest figures into pxStats.
+ */
+void vLoadMonitorGetStats( LoadStats_st *pxStats );
+
+/*
+ * Returns pdTRUE if the smoothed load is more than ulMargin above the
+ * declared utilization.
+ */
+BaseType_t xLoadMonitorIsOverloaded( uint32_t ulMargin );
+
+#endif /* LOAD_MONITOR_H */
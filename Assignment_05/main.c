@@ -59,12 +59,19 @@
 /* Scheduler includes. */
 #include "FreeRTOS.h"
 #include "task.h"
+#include "edf_task.h"
 #include "lpc21xx.h"
 
 /* Peripheral includes. */
 #include "serial.h"
 #include "GPIO.h"
 
+/* Application includes. */
+#include "load_monitor.h"
+#include "kernel_stats.h"
+#include "edf_static.h"
+#include "task_table.h"
+
 
 /*-----------------------------------------------------------*/
 
@@ -89,12 +96,33 @@
 #define DELAY_OFFSET(t) DELAY_OFFSET2(t)
 #define DELAY_OFFSET2(t) DELAY_OFFSET_##t
 
+// Task creation timed at boot: 0 from the static table, 1 the same table from the heap
+#define BOOT_DYNAMIC_TASKS 0
+
 // Task Related Macros
 #define TASKA_PERIOD 5
 #define TASKA_CAPACITY 2
+#define TASKA_MAX_NPR 0 // Fully preemptive
 
 #define TASKB_PERIOD 8
 #define TASKB_CAPACITY 2
+#define TASKB_MAX_NPR 0 // Fully preemptive
+
+// Task table: X(a, id, function, name, stack, period, deadline, capacity, max NPR, tag), by increasing deadline
+#define TASK_TABLE(X, a) \
+	X(a, taskA, Task_A, "Task A", 50, TASKA_PERIOD, TASKA_PERIOD, TASKA_CAPACITY, TASKA_MAX_NPR, TASKA_TAG) \
+	X(a, taskB, Task_B, "Task B", 50, TASKB_PERIOD, TASKB_PERIOD, TASKB_CAPACITY, TASKB_MAX_NPR, TASKB_TAG)
+
+// The same tasks checked at build time
+#define TASK_SET(X, a) TASK_TABLE(TASK_TABLE_SET_ROW, (X, a))
+
+EDF_STATIC_CHECK(TASK_SET);
+
+#define HYPERPERIOD EDF_HYPERPERIOD(TASK_SET) // lcm(TASKA_PERIOD, TASKB_PERIOD)
+
+#if (configUSE_EDF_TIME_TRIGGERED == 1)
+EDF_STATIC_ASSERT(HYPERPERIOD <= configEDF_TT_MAX_SLOTS, "Dispatch table shorter than the hyperperiod");
+#endif
 
 
 // Task Handlers
@@ -104,7 +132,11 @@ TaskHandle_t taskB_handle;
 // Run-time analysis
 int taskA_in_time, taskA_out_time, taskA_total_time;
 int taskB_in_time, taskB_out_time, taskB_total_time;
-//int system_time, CPU_load;
+unsigned long boot_create_cycles; // CPU cycles spent creating the task table
+unsigned long boot_cycles; // CPU cycles from the start of main() to the first job
+BaseType_t task_table_created = pdFAIL; // Result of the task table creation
+int kernel_total_time; // Timer 1 counts spent in the tick, the switch and the kernel critical sections
+BaseType_t tt_dispatch = pdFAIL; // pdPASS when the time-triggered table runs, pdFAIL on online EDF
 
 
 /*
@@ -117,12 +149,22 @@ static void prvSetupHardware( void );
 
 void timer1Reset(void);
 void configTimer1(void);
+unsigned long timer1Cycles(void);
+void bootDone(void);
 
 
 // Tasks
 void Task_A(void *pvParameters);
 void Task_B(void *pvParameters);
 
+TASK_TABLE(TASK_TABLE_STORAGE, 0)
+
+static const TaskTableEntry_st task_table[] = { TASK_TABLE(TASK_TABLE_ENTRY, 0) };
+
+// Idle task memory, configSUPPORT_STATIC_ALLOCATION is set
+static StackType_t idle_stack[configMINIMAL_STACK_SIZE];
+static EDFStaticTask_t idle_tcb; // Not a StaticTask_t, too small for the EDF TCB
+
 /*
  * Application entry point:
  * Starts all the other tasks, then starts the scheduler. 
@@ -138,26 +180,28 @@ int main( void )
 	
   /* Create Tasks here */
 	
-	xTaskPeriodicCreate(Task_A, // Function that implements the task.
-              "Task A", // Text name for the task.
-              50, // Stack size in words, not bytes.
-              (void *) 0, // Parameter passed into the task.
-              1, // Priority at which the task is created.
-              &taskA_handle, // Used to pass out the created task's handle.
-							TASKA_PERIOD);
-							
-	vTaskSetApplicationTaskTag(taskA_handle, (TaskHookFunction_t)TASKA_TAG);
-							
-	xTaskPeriodicCreate(Task_B, // Function that implements the task.
-              "Task B", // Text name for the task.
-              50, // Stack size in words, not bytes.
-              (void *) 0, // Parameter passed into the task.
-              1, // Priority at which the task is created.
-              &taskB_handle, // Used to pass out the created task's handle.
-							TASKB_PERIOD);
+	// Static stacks and TCBs, no heap traffic before the scheduler starts (the heap with BOOT_DYNAMIC_TASKS, to compare)
+	boot_create_cycles = timer1Cycles();
+	#if (BOOT_DYNAMIC_TASKS == 1)
+	task_table_created = xTaskTableCreateDynamic(task_table, sizeof(task_table) / sizeof(task_table[0]));
+	#else
+	task_table_created = xTaskTableCreate(task_table, sizeof(task_table) / sizeof(task_table[0]));
+	#endif
+	boot_create_cycles = timer1Cycles() - boot_create_cycles;
 	
-	vTaskSetApplicationTaskTag(taskB_handle, (TaskHookFunction_t)TASKB_TAG);
+	// An unschedulable table or a full heap never reaches the scheduler
+	if(task_table_created != pdPASS)
+	{
+		for(;;);
+	}
 							
+	// Dispatch table over the hyperperiod, the kernel stays on online EDF if it cannot be built
+	#if (configUSE_EDF_TIME_TRIGGERED == 1)
+	tt_dispatch = xTaskTimeTriggeredBuild();
+	#endif
+	
+	// Idle time against Timer 1, read with vLoadMonitorGetStats()
+	vLoadMonitorInit(HYPERPERIOD);
 	
 
 	/* Now all the tasks have been started - start the scheduler.
@@ -180,17 +224,18 @@ static void prvSetupHardware( void )
 	/* Perform the hardware setup required.  This is minimal as most of the
 	setup is managed by the settings in the project file. */
 
+	/* Setup the peripheral bus to be the same as the PLL output. */
+	VPBDIV = mainBUS_CLK_FULL;
+	
+	/* Configure trace timer 1 and read T1TC to get the current tick, first so
+	the boot time counts the whole setup */
+	configTimer1();
+
 	/* Configure UART */
 	xSerialPortInitMinimal(mainCOM_TEST_BAUD_RATE);
 
 	/* Configure GPIO */
 	GPIO_init();
-	
-	/* Configure trace timer 1 and read T1TC to get the current tick */
-	configTimer1();
-
-	/* Setup the peripheral bus to be the same as the PLL output. */
-	VPBDIV = mainBUS_CLK_FULL;
 }
 /*-----------------------------------------------------------*/
 
@@ -206,32 +251,76 @@ void configTimer1(void)
 	T1TCR |= 0x1;
 }
 
+// Timer 1 time in CPU cycles, the prescale counter adds the cycles within a count
+unsigned long timer1Cycles(void)
+{
+	unsigned long tc, pc;
+	
+	do
+	{
+		tc = T1TC;
+		pc = T1PC;
+	} while(tc != T1TC);
+	
+	return (tc * (T1PR + 1)) + pc;
+}
+
 
 /*-----------------------------------------------------------*/
 
 // Hooks
 
+// Idle task memory, requested by vTaskStartScheduler()
+void vApplicationGetEDFIdleTaskMemory(EDFStaticTask_t **ppxIdleTaskTCBBuffer, StackType_t **ppxIdleTaskStackBuffer, uint32_t *pulIdleTaskStackSize)
+{
+	*ppxIdleTaskTCBBuffer = &idle_tcb;
+	*ppxIdleTaskStackBuffer = idle_stack;
+	*pulIdleTaskStackSize = configMINIMAL_STACK_SIZE;
+}
+
 // Tick Hook
 void vApplicationTickHook(void)
 {
+	STATS_HOOKS_ENTER();
+	
 	GPIO_write(PORT_0, PIN1, PIN_IS_HIGH);
 	GPIO_write(PORT_0, PIN1, PIN_IS_LOW);
+	
+	vLoadMonitorTickFromISR();
+	
+#if (configUSE_KERNEL_STATS == 1)
+	// Per path min, max and histogram with vKernelStatsGetPath()
+	kernel_total_time = ulKernelStatsGetTotal();
+#endif
+	
+	STATS_HOOKS_EXIT();
 }
 
 /*-----------------------------------------------------------*/
 
 // Tasks to be created
 
+// Boot time, taken by the first job to run
+void bootDone(void)
+{
+	if(boot_cycles == 0)
+	{
+		boot_cycles = timer1Cycles();
+	}
+}
+
 void Task_A(void *pvParameters)
 {
 	volatile int i, j;
 	unsigned int xLastWakeTime = 0;//xTaskGetTickCount();
 	
+	bootDone();
+	
 	while(1)
 	{
 		DELAY_LOOP(TASKA_CAPACITY, j, i);
 		
-		vTaskDelayUntil(&xLastWakeTime, TASKA_PERIOD);
+		xTaskDelayUntilNextPeriod(&xLastWakeTime); // Follows period updates at the job boundary
 	}
 }
 
@@ -241,11 +330,13 @@ void Task_B(void *pvParameters)
 	volatile int i, j;
 	unsigned int xLastWakeTime = 0;//xTaskGetTickCount();
 	
+	bootDone();
+	
 	while(1)
 	{
 		DELAY_LOOP(TASKB_CAPACITY, j, i);
 		
-		vTaskDelayUntil(&xLastWakeTime, TASKB_PERIOD);
+		xTaskDelayUntilNextPeriod(&xLastWakeTime); // Follows period updates at the job boundary
 	}
 }
 
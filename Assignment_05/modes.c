@@ -0,0 +1,288 @@
+/*
+ * Mode-change manager for the EDF scheduler, see modes.h.
+ */
+
+/* Scheduler includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "edf_task.h"
+
+#include "modes.h"
+
+// Rounded up density C/D, keeps the figures on the safe side
+#define MODE_DENSITY(pxTask) ( ( ( ( uint32_t ) ( pxTask )->xCapacity * MODE_UTILIZATION_SCALE ) + ( pxTask )->xDeadline - 1UL ) / ( pxTask )->xDeadline )
+
+// Global Variables
+static const Mode_st *pxModeTable = NULL;
+static UBaseType_t uxModeCount = 0;
+static UBaseType_t uxCurrentMode = 0;
+static BaseType_t xModeChangeInProgress = pdFALSE;
+static TickType_t xLastLatency = 0;
+
+// Prototypes
+static const ModeTask_st * prvModeFind( const Mode_st *pxMode, TaskHandle_t xTask );
+static uint32_t prvModeDensity( const Mode_st *pxMode );
+static TickType_t prvModeOffset( const Mode_st *pxOld, const Mode_st *pxNew );
+
+/*-----------------------------------------------------------*/
+
+static const ModeTask_st * prvModeFind( const Mode_st *pxMode, TaskHandle_t xTask )
+{
+	UBaseType_t uxIndex;
+
+	for( uxIndex = 0; uxIndex < pxMode->uxTaskCount; uxIndex++ )
+	{
+		if( *( pxMode->pxTasks[ uxIndex ].pxHandle ) == xTask )
+		{
+			return &pxMode->pxTasks[ uxIndex ];
+		}
+	}
+
+	return NULL;
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvModeDensity( const Mode_st *pxMode )
+{
+	UBaseType_t uxIndex;
+	uint32_t ulDensity = 0;
+
+	for( uxIndex = 0; uxIndex < pxMode->uxTaskCount; uxIndex++ )
+	{
+		ulDensity += MODE_DENSITY( &pxMode->pxTasks[ uxIndex ] );
+	}
+
+	return ulDensity;
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * Delay between the request and the release of the new tasks.  While the
+ * change is in progress the CPU may see the leaving tasks with their old
+ * parameters, the entering tasks with their new ones and the staying tasks
+ * with the larger of the two.  If that fits there is nothing to wait for,
+ * otherwise the new tasks wait until every leaving job has reached its
+ * deadline.
+ */
+static TickType_t prvModeOffset( const Mode_st *pxOld, const Mode_st *pxNew )
+{
+	const ModeTask_st *pxTask, *pxOther;
+	UBaseType_t uxIndex;
+	uint32_t ulDensity = 0, ulOld, ulNew;
+	TickType_t xOffset = 0;
+
+	for( uxIndex = 0; uxIndex < pxOld->uxTaskCount; uxIndex++ )
+	{
+		pxTask = &pxOld->pxTasks[ uxIndex ];
+		pxOther = prvModeFind( pxNew, *( pxTask->pxHandle ) );
+
+		if( pxOther == NULL )
+		{
+			// Leaving task
+			ulDensity += MODE_DENSITY( pxTask );
+
+			if( pxTask->xDeadline > xOffset )
+			{
+				xOffset = pxTask->xDeadline;
+			}
+		}
+		else
+		{
+			// Staying task
+			ulOld = MODE_DENSITY( pxTask );
+			ulNew = MODE_DENSITY( pxOther );
+			ulDensity += ( ulOld > ulNew ) ? ulOld : ulNew;
+		}
+	}
+
+	for( uxIndex = 0; uxIndex < pxNew->uxTaskCount; uxIndex++ )
+	{
+		pxTask = &pxNew->pxTasks[ uxIndex ];
+
+		if( prvModeFind( pxOld, *( pxTask->pxHandle ) ) == NULL )
+		{
+			// Entering task
+			ulDensity += MODE_DENSITY( pxTask );
+		}
+	}
+
+	return ( ulDensity <= MODE_UTILIZATION_SCALE ) ? 0 : xOffset;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xModeInit( const Mode_st *pxModes,
+                      UBaseType_t uxModes,
+                      UBaseType_t uxInitialMode )
+{
+	const Mode_st *pxInitial;
+	const ModeTask_st *pxTask;
+	UBaseType_t uxMode, uxIndex;
+	BaseType_t xReturn = pdPASS;
+
+	configASSERT( ( pxModes != NULL ) && ( uxInitialMode < uxModes ) );
+
+	pxModeTable = pxModes;
+	uxModeCount = uxModes;
+	uxCurrentMode = uxInitialMode;
+	pxInitial = &pxModes[ uxInitialMode ];
+
+	// Tasks of the other modes wait for xTaskPeriodicActivate()
+	for( uxMode = 0; uxMode < uxModes; uxMode++ )
+	{
+		for( uxIndex = 0; uxIndex < pxModes[ uxMode ].uxTaskCount; uxIndex++ )
+		{
+			pxTask = &pxModes[ uxMode ].pxTasks[ uxIndex ];
+
+			if( prvModeFind( pxInitial, *( pxTask->pxHandle ) ) == NULL )
+			{
+				vTaskPeriodicDeactivate( *( pxTask->pxHandle ) );
+			}
+		}
+	}
+
+	for( uxIndex = 0; uxIndex < pxInitial->uxTaskCount; uxIndex++ )
+	{
+		pxTask = &pxInitial->pxTasks[ uxIndex ];
+
+		if( xTaskPeriodicSetParameters( *( pxTask->pxHandle ), pxTask->xPeriod, pxTask->xDeadline, pxTask->xCapacity ) != pdPASS )
+		{
+			xReturn = pdFAIL;
+		}
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xModeChange( UBaseType_t uxNewMode )
+{
+	const Mode_st *pxOld, *pxNew;
+	const ModeTask_st *pxTask, *pxOther;
+	UBaseType_t uxIndex;
+	TickType_t xStart, xOffset;
+	BaseType_t xReturn = pdPASS;
+
+	configASSERT( ( pxModeTable != NULL ) && ( uxNewMode < uxModeCount ) );
+
+	taskENTER_CRITICAL();
+	{
+		if( xModeChangeInProgress != pdFALSE )
+		{
+			xReturn = MODE_BUSY;
+		}
+		else
+		{
+			xModeChangeInProgress = pdTRUE;
+		}
+	}
+	taskEXIT_CRITICAL();
+
+	if( xReturn != pdPASS )
+	{
+		return xReturn;
+	}
+
+	pxOld = &pxModeTable[ uxCurrentMode ];
+	pxNew = &pxModeTable[ uxNewMode ];
+
+	if( uxNewMode == uxCurrentMode )
+	{
+		xLastLatency = 0;
+	}
+	else if( prvModeDensity( pxNew ) > MODE_UTILIZATION_SCALE )
+	{
+		xReturn = MODE_NOT_SCHEDULABLE;
+	}
+	else
+	{
+		xStart = xTaskGetTickCount();
+		xOffset = prvModeOffset( pxOld, pxNew );
+
+		// Leaving tasks stop at the end of their current job
+		for( uxIndex = 0; uxIndex < pxOld->uxTaskCount; uxIndex++ )
+		{
+			pxTask = &pxOld->pxTasks[ uxIndex ];
+
+			if( prvModeFind( pxNew, *( pxTask->pxHandle ) ) == NULL )
+			{
+				vTaskPeriodicDeactivate( *( pxTask->pxHandle ) );
+			}
+		}
+
+		// Staying tasks whose load drops switch at their next release
+		for( uxIndex = 0; uxIndex < pxNew->uxTaskCount; uxIndex++ )
+		{
+			pxTask = &pxNew->pxTasks[ uxIndex ];
+			pxOther = prvModeFind( pxOld, *( pxTask->pxHandle ) );
+
+			if( ( pxOther != NULL ) && ( MODE_DENSITY( pxTask ) <= MODE_DENSITY( pxOther ) ) )
+			{
+				if( xTaskPeriodicSetParameters( *( pxTask->pxHandle ), pxTask->xPeriod, pxTask->xDeadline, pxTask->xCapacity ) != pdPASS )
+				{
+					xReturn = pdFAIL;
+				}
+			}
+		}
+
+		// Let the leaving jobs reach their deadlines
+		if( xOffset > 0 )
+		{
+			vTaskDelay( xOffset );
+		}
+
+		// Staying tasks whose load grows, then the entering tasks
+		for( uxIndex = 0; uxIndex < pxNew->uxTaskCount; uxIndex++ )
+		{
+			pxTask = &pxNew->pxTasks[ uxIndex ];
+			pxOther = prvModeFind( pxOld, *( pxTask->pxHandle ) );
+
+			if( ( pxOther != NULL ) && ( MODE_DENSITY( pxTask ) > MODE_DENSITY( pxOther ) ) )
+			{
+				if( xTaskPeriodicSetParameters( *( pxTask->pxHandle ), pxTask->xPeriod, pxTask->xDeadline, pxTask->xCapacity ) != pdPASS )
+				{
+					xReturn = pdFAIL;
+				}
+			}
+			else if( pxOther == NULL )
+			{
+				if( ( xTaskPeriodicSetParameters( *( pxTask->pxHandle ), pxTask->xPeriod, pxTask->xDeadline, pxTask->xCapacity ) != pdPASS ) ||
+					( xTaskPeriodicActivate( *( pxTask->pxHandle ) ) != pdPASS ) )
+				{
+					xReturn = pdFAIL;
+				}
+			}
+		}
+
+		uxCurrentMode = uxNewMode;
+		xLastLatency = xTaskGetTickCount() - xStart;
+	}
+
+	xModeChangeInProgress = pdFALSE;
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxModeGetCurrent( void )
+{
+	return uxCurrentMode;
+}
+/*-----------------------------------------------------------*/
+
+TickType_t xModeGetLatencyBound( UBaseType_t uxNewMode )
+{
+	configASSERT( ( pxModeTable != NULL ) && ( uxNewMode < uxModeCount ) );
+
+	if( uxNewMode == uxCurrentMode )
+	{
+		return 0;
+	}
+
+	return prvModeOffset( &pxModeTable[ uxCurrentMode ], &pxModeTable[ uxNewMode ] );
+}
+/*-----------------------------------------------------------*/
+
+TickType_t xModeGetLastLatency( void )
+{
+	return xLastLatency;
+}
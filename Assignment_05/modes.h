@@ -0,0 +1,82 @@
+/*
+ * Mode-change manager for the EDF scheduler.
+ *
+ * A mode is a set of periodic tasks with their timing parameters.  Every task
+ * of every mode is created once with xTaskPeriodicCreate(), the manager then
+ * decides which of them run.  On a mode change the tasks leaving the mode
+ * stop at the end of their current job, the tasks staying in the mode get
+ * their new parameters at their next release and the tasks entering the mode
+ * are released once the old jobs can no longer interfere with them.
+ *
+ * The new tasks are released at once when the old and the new task sets fit
+ * together (density <= 1), otherwise after the largest relative deadline of
+ * the leaving tasks.  That delay is the latency bound of the mode change.
+ *
+ * Tasks handled by the manager are created with a capacity of 0, so the tasks
+ * of all the modes do not go through the admission test together, and must
+ * wait for their next release with xTaskDelayUntilNextPeriod().
+ */
+
+#ifndef MODES_H
+#define MODES_H
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+// Returned by xModeChange() when the new mode is not schedulable on its own
+#define MODE_NOT_SCHEDULABLE ( ( BaseType_t ) -6 )
+
+// Returned by xModeChange() when another mode change is in progress
+#define MODE_BUSY ( ( BaseType_t ) -7 )
+
+// Utilization reached by 100 % of the CPU
+#define MODE_UTILIZATION_SCALE ( ( uint32_t ) 10000UL )
+
+// Type definitions
+typedef struct
+{
+	TaskHandle_t *pxHandle; // Filled by xTaskPeriodicCreate()
+	TickType_t xPeriod;
+	TickType_t xDeadline;
+	TickType_t xCapacity;
+} ModeTask_st;
+
+typedef struct
+{
+	const ModeTask_st *pxTasks;
+	UBaseType_t uxTaskCount;
+} Mode_st;
+
+/*
+ * Sets the table of modes and enters the initial one.  Must be called after
+ * every task of every mode has been created and before the scheduler starts.
+ * Tasks that are not part of the initial mode are suspended.
+ */
+BaseType_t xModeInit( const Mode_st *pxModes,
+                      UBaseType_t uxModeCount,
+                      UBaseType_t uxInitialMode );
+
+/*
+ * Switches to mode uxNewMode.  Blocks the calling task for the latency of the
+ * change, so it must be called from a task that is not part of any mode.
+ * Returns pdPASS, MODE_NOT_SCHEDULABLE or MODE_BUSY.
+ */
+BaseType_t xModeChange( UBaseType_t uxNewMode );
+
+/*
+ * Returns the index of the current mode.
+ */
+UBaseType_t uxModeGetCurrent( void );
+
+/*
+ * Returns the worst case latency of a change from the current mode to
+ * uxNewMode, in ticks.
+ */
+TickType_t xModeGetLatencyBound( UBaseType_t uxNewMode );
+
+/*
+ * Returns the latency of the last completed mode change, in ticks.
+ */
+TickType_t xModeGetLastLatency( void );
+
+#endif /* MODES_H */
@@ -0,0 +1,100 @@
+/*
+ * Static task table for the EDF scheduler, see task_table.h.
+ */
+
+/* Scheduler includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "edf_task.h"
+
+#include "task_table.h"
+
+/*-----------------------------------------------------------*/
+
+BaseType_t xTaskTableCreate( const TaskTableEntry_st *pxTable,
+                             UBaseType_t uxCount )
+{
+	const TaskTableEntry_st *pxEntry;
+	UBaseType_t uxIndex = uxCount;
+	BaseType_t xReturn;
+
+	configASSERT( pxTable != NULL );
+
+	// Latest deadline first, each task lands at the head of the ready list
+	while( uxIndex > 0 )
+	{
+		uxIndex--;
+		pxEntry = &pxTable[ uxIndex ];
+
+		configASSERT( ( uxIndex == 0 ) || ( pxTable[ uxIndex - 1 ].xDeadline <= pxEntry->xDeadline ) );
+
+		xReturn = xTaskPeriodicCreateStatic( pxEntry->pxTaskCode,
+		                                     pxEntry->pcName,
+		                                     pxEntry->ulStackDepth,
+		                                     NULL,
+		                                     tskIDLE_PRIORITY + 1,
+		                                     pxEntry->pxHandle,
+		                                     pxEntry->puxStack,
+		                                     pxEntry->pxTCB,
+		                                     pxEntry->xPeriod,
+		                                     pxEntry->xDeadline,
+		                                     pxEntry->xCapacity,
+		                                     pxEntry->xMaxNPR );
+
+		if( xReturn != pdPASS )
+		{
+			return xReturn;
+		}
+
+		#if (configUSE_APPLICATION_TASK_TAG == 1)
+		vTaskSetApplicationTaskTag( *pxEntry->pxHandle, pxEntry->pxTag );
+		#endif
+	}
+
+	return pdPASS;
+}
+/*-----------------------------------------------------------*/
+
+#if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+
+BaseType_t xTaskTableCreateDynamic( const TaskTableEntry_st *pxTable,
+                                    UBaseType_t uxCount )
+{
+	const TaskTableEntry_st *pxEntry;
+	UBaseType_t uxIndex = uxCount;
+	BaseType_t xReturn;
+
+	configASSERT( pxTable != NULL );
+
+	// Same order as xTaskTableCreate(), so only the allocation differs
+	while( uxIndex > 0 )
+	{
+		uxIndex--;
+		pxEntry = &pxTable[ uxIndex ];
+
+		configASSERT( pxEntry->xDeadline == pxEntry->xPeriod );
+
+		xReturn = xTaskPeriodicCreate( pxEntry->pxTaskCode,
+		                               pxEntry->pcName,
+		                               ( configSTACK_DEPTH_TYPE ) pxEntry->ulStackDepth,
+		                               NULL,
+		                               tskIDLE_PRIORITY + 1,
+		                               pxEntry->pxHandle,
+		                               pxEntry->xPeriod,
+		                               pxEntry->xCapacity,
+		                               pxEntry->xMaxNPR );
+
+		if( xReturn != pdPASS )
+		{
+			return xReturn;
+		}
+
+		#if (configUSE_APPLICATION_TASK_TAG == 1)
+		vTaskSetApplicationTaskTag( *pxEntry->pxHandle, pxEntry->pxTag );
+		#endif
+	}
+
+	return pdPASS;
+}
+
+#endif /* configSUPPORT_DYNAMIC_ALLOCATION */
@@ -0,0 +1,86 @@
+/*
+ * Static task table for the EDF scheduler.
+ *
+ * The periodic tasks of the application are declared once, in an X-macro
+ * list that calls X once per task, passing a through as is:
+ *
+ *   #define TASK_TABLE(X, a) \
+ *       X(a, id, function, name, stack, period, deadline, capacity, maxNPR, tag) \
+ *       ...
+ *
+ * TASK_TABLE(TASK_TABLE_STORAGE, 0) declares the stack and the TCB of every
+ * task at file scope, so they are placed by the linker.
+ * { TASK_TABLE(TASK_TABLE_ENTRY, 0) } initializes a TaskTableEntry_st array,
+ * and xTaskTableCreate() creates the tasks from it without touching the
+ * heap.  The handle of each task is written to id##_handle, which the
+ * application declares.
+ *
+ * The same list is the task set of the build-time checks of edf_static.h:
+ *
+ *   #define TASK_SET(X, a) TASK_TABLE(TASK_TABLE_SET_ROW, (X, a))
+ *   EDF_STATIC_CHECK(TASK_SET);
+ *
+ * List the tasks by increasing deadline.  The table is walked backwards, so
+ * every task is inserted at the head of the EDF ready list in O(1).
+ *
+ * Requires configSUPPORT_STATIC_ALLOCATION set to 1.
+ */
+
+#ifndef TASK_TABLE_H
+#define TASK_TABLE_H
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "edf_task.h"
+
+// Type definitions
+typedef struct
+{
+	TaskFunction_t pxTaskCode;
+	const char *pcName;
+	StackType_t *puxStack;
+	uint32_t ulStackDepth; // In words, not bytes
+	EDFStaticTask_t *pxTCB; // Sized for the EDF fields of the TCB
+	TickType_t xPeriod;
+	TickType_t xDeadline;
+	TickType_t xCapacity;
+	TickType_t xMaxNPR;
+	TaskHookFunction_t pxTag;
+	TaskHandle_t *pxHandle;
+} TaskTableEntry_st;
+
+#define TASK_TABLE_STORAGE(a, id, function, name, stack, period, deadline, capacity, maxNPR, tag) \
+	static StackType_t id##_stack[ stack ]; \
+	static EDFStaticTask_t id##_tcb;
+
+#define TASK_TABLE_ENTRY(a, id, function, name, stack, period, deadline, capacity, maxNPR, tag) \
+	{ (function), (name), id##_stack, (stack), &id##_tcb, (period), (deadline), (capacity), (maxNPR), (TaskHookFunction_t)(tag), &id##_handle },
+
+// Row of an edf_static.h task set, pass is the (X, a) pair of the set
+#define TASK_TABLE_SET_ROW(pass, id, function, name, stack, period, deadline, capacity, maxNPR, tag) \
+	TASK_TABLE_SET_CALL(TASK_TABLE_SET_X pass, TASK_TABLE_SET_A pass, period, deadline, capacity, maxNPR)
+#define TASK_TABLE_SET_CALL(X, a, period, deadline, capacity, maxNPR) X(a, period, deadline, capacity, maxNPR)
+#define TASK_TABLE_SET_X(X, a) X
+#define TASK_TABLE_SET_A(X, a) a
+
+/*
+ * Creates the uxCount tasks of pxTable.  Call it before the scheduler
+ * starts.  Returns pdPASS, or the error of the first task that
+ * xTaskPeriodicCreateStatic() refused (-6 when it fails the admission test).
+ */
+BaseType_t xTaskTableCreate( const TaskTableEntry_st *pxTable,
+                             UBaseType_t uxCount );
+
+/*
+ * Same as xTaskTableCreate() with the stacks and the TCBs taken from the
+ * heap by xTaskPeriodicCreate(), to compare the two paths; the storage of
+ * the table is not used.  Every deadline must equal its period.  Returns
+ * pdPASS, or the error of the first task that xTaskPeriodicCreate()
+ * refused.
+ */
+#if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+BaseType_t xTaskTableCreateDynamic( const TaskTableEntry_st *pxTable,
+                                    UBaseType_t uxCount );
+#endif
+
+#endif /* TASK_TABLE_H */
@@ -37,6 +37,8 @@
 #include "FreeRTOS.h"
 #include "task.h"
 #include "timers.h"
+#include "edf_task.h"
+#include "edf_static.h"
 #include "stack_macros.h"
 
 /* Lint e9021, e961 and e750 are suppressed as a MISRA exception justified
@@ -216,7 +218,26 @@
  * Place the task represented by pxTCB into the appropriate ready list for
  * the task.  It is inserted at the end of the list.
  */
-		
+
+// EDF code: trace hooks bracketing the kernel paths, for overhead accounting (see kernel_stats.h)
+#ifndef traceTASK_INCREMENT_TICK_EXIT
+	#define traceTASK_INCREMENT_TICK_EXIT()
+#endif
+#ifndef traceTASK_SWITCH_CONTEXT_ENTER
+	#define traceTASK_SWITCH_CONTEXT_ENTER()
+#endif
+#ifndef traceTASK_SWITCH_CONTEXT_EXIT
+	#define traceTASK_SWITCH_CONTEXT_EXIT()
+#endif
+
+// EDF code: the critical sections of this file report their line, the hooks run with interrupts disabled
+#if defined( traceTASK_CRITICAL_ENTER ) && defined( traceTASK_CRITICAL_EXIT )
+	#undef taskENTER_CRITICAL
+	#define taskENTER_CRITICAL()	do { portENTER_CRITICAL(); traceTASK_CRITICAL_ENTER( __LINE__ ); } while( 0 )
+	#undef taskEXIT_CRITICAL
+	#define taskEXIT_CRITICAL()		do { traceTASK_CRITICAL_EXIT(); portEXIT_CRITICAL(); } while( 0 )
+#endif
+
 // EDF code: prvAddTaskToReadyList
 #if (configUSE_EDF_SCHEDULER == 0)
 #define prvAddTaskToReadyList( pxTCB )                                                                 \
@@ -224,6 +245,18 @@
     taskRECORD_READY_PRIORITY( ( pxTCB )->uxPriority );                                                \
     vListInsertEnd( &( pxReadyTasksLists[ ( pxTCB )->uxPriority ] ), &( ( pxTCB )->xStateListItem ) ); \
     tracePOST_MOVED_TASK_TO_READY_STATE( pxTCB )
+#elif (configUSE_EDF_STRIDE_BAND == 1)
+#define prvAddTaskToReadyList( pxTCB )	/* xStateListItem must contain the deadline value */			\
+traceMOVED_TASK_TO_READY_STATE( pxTCB );																\
+if( ( pxTCB )->uxStrideTickets > ( UBaseType_t ) 0U )													\
+{																										\
+	prvStrideAddTaskToReadyList( pxTCB );	/* The band sets its own pass value */						\
+}																										\
+else																									\
+{																										\
+	vListInsert( &xReadyTasksListEDF, &( ( pxTCB )->xStateListItem ) );									\
+}																										\
+tracePOST_MOVED_TASK_TO_READY_STATE( pxTCB )
 #else
 #define prvAddTaskToReadyList( pxTCB )	/* xStateListItem must contain the deadline value */			\
 traceMOVED_TASK_TO_READY_STATE( pxTCB );																\
@@ -231,6 +264,17 @@ vListInsert( &xReadyTasksListEDF, &( ( pxTCB )->xStateListItem ) );										\
 tracePOST_MOVED_TASK_TO_READY_STATE( pxTCB )
 #endif
 
+// EDF code: pxA must run before pxB
+#if (configUSE_EDF_STRIDE_BAND == 1)
+/* Real-time jobs run before the band, the band runs before the idle task */
+#define prvEDFRunsBefore( pxA, pxB )																	\
+( ( ( ( pxA )->uxStrideTickets > ( UBaseType_t ) 0U ) == ( ( pxB )->uxStrideTickets > ( UBaseType_t ) 0U ) ) ?	\
+  ( listGET_LIST_ITEM_VALUE( &( ( pxA )->xStateListItem ) ) <= listGET_LIST_ITEM_VALUE( &( ( pxB )->xStateListItem ) ) ) :	\
+  ( ( ( pxA )->uxStrideTickets > ( UBaseType_t ) 0U ) ? ( ( pxB ) == xIdleTaskHandle ) : ( ( pxA ) != xIdleTaskHandle ) ) )
+#elif (configUSE_EDF_SCHEDULER == 1)
+#define prvEDFRunsBefore( pxA, pxB ) ( listGET_LIST_ITEM_VALUE( &( ( pxA )->xStateListItem ) ) <= listGET_LIST_ITEM_VALUE( &( ( pxB )->xStateListItem ) ) )
+#endif
+
 /*-----------------------------------------------------------*/
 
 /*
@@ -255,6 +299,13 @@ tracePOST_MOVED_TASK_TO_READY_STATE( pxTCB )
     #define taskEVENT_LIST_ITEM_VALUE_IN_USE    0x80000000UL
 #endif
 
+// EDF code: the event list item of a task waiting on a queue or semaphore is keyed by its job deadline
+#if (configUSE_EDF_SCHEDULER == 1)
+    #define prvEventItemValueIsFree( pxTCB )    ( ( ( listGET_LIST_ITEM_VALUE( &( ( pxTCB )->xEventListItem ) ) & taskEVENT_LIST_ITEM_VALUE_IN_USE ) == 0UL ) && ( ( ( pxTCB )->ucPeriodicState & edfEVENT_DEADLINE ) == 0U ) )
+#else
+    #define prvEventItemValueIsFree( pxTCB )    ( ( listGET_LIST_ITEM_VALUE( &( ( pxTCB )->xEventListItem ) ) & taskEVENT_LIST_ITEM_VALUE_IN_USE ) == 0UL )
+#endif
+
 /*
  * Task control block.  A task control block (TCB) is allocated for each task,
  * and stores task state information, including a pointer to the task's context
@@ -268,12 +319,39 @@ typedef struct tskTaskControlBlock       /* The old naming convention is used to
         xMPU_SETTINGS xMPUSettings; /*< The MPU settings are defined as part of the port layer.  THIS MUST BE THE SECOND MEMBER OF THE TCB STRUCT. */
     #endif
 
+	// EDF code: hot layout, the state list item first, then the fields below up to xTaskCapacity fill 64 bytes
+	// with 32-bit ticks and no MPU: a list walk or a tick touches one cache line of each TCB it reads
+	#if (configEDF_HOT_TCB_LAYOUT == 1)
+	ListItem_t xStateListItem; /*< The list that the state list item of a task is reference from denotes the state of that task (Ready, Blocked, Suspended ). */
+	#endif
+
+	// EDF code: stride band bookkeeping
+	#if (configUSE_EDF_STRIDE_BAND == 1)
+	UBaseType_t uxStrideTickets; /*< Share of the leftover CPU, 0 if the task is not in the band */
+	TickType_t xStride; /*< Pass added for every tick of CPU, edfSTRIDE1 / uxStrideTickets */
+	TickType_t xStridePass; /*< Virtual time of the task, the smallest pass runs first */
+	UBaseType_t uxStrideEpoch; /*< Rebase count the pass refers to */
+	#endif
+
+	// EDF code: Limited preemption bookkeeping
+	#if (configUSE_EDF_LIMITED_PREEMPTION == 1)
+	TickType_t xTaskMaxNPR; /*< Longest non-preemptive region (Q) in ticks, 0 if the task is fully preemptive */
+	UBaseType_t uxNPRNesting; /*< Non-preemptive region nesting depth, 0 when the task can be preempted */
+	TickType_t xNPRTicks; /*< Ticks executed since the region began or the last preemption point */
+	#endif
+
 	// EDF code: Period value to help in task deadline calculation
 	#if (configUSE_EDF_SCHEDULER == 1)
 	TickType_t xTaskPeriod; /*< Stores the period in tick of the task */
+	TickType_t xTaskDeadline; /*< Relative deadline in ticks, never longer than the period */
+	TickType_t xTaskCapacity; /*< Worst case execution time in ticks, 0 if the task is not admission controlled */
+	TickType_t xJobDeadline; /*< Absolute deadline of the job blocked on an event, xStateListItem holds the wake time meanwhile */
+	uint8_t ucPeriodicState; /*< edfDEACTIVATE_PENDING and edfACTIVATED flags used by mode changes */
 	#endif
-		
+
+	#if (configEDF_HOT_TCB_LAYOUT == 0)
     ListItem_t xStateListItem;                  /*< The list that the state list item of a task is reference from denotes the state of that task (Ready, Blocked, Suspended ). */
+	#endif
     ListItem_t xEventListItem;                  /*< Used to reference a task from an event list. */
     UBaseType_t uxPriority;                     /*< The priority of the task.  0 is the lowest priority. */
     StackType_t * pxStack;                      /*< Points to the start of the stack. */
@@ -348,6 +426,11 @@ typedef struct tskTaskControlBlock       /* The old naming convention is used to
  * below to enable the use of older kernel aware debuggers. */
 typedef tskTCB TCB_t;
 
+// EDF code: static TCB buffers must hold the EDF fields, see edf_task.h
+#if ( ( configUSE_EDF_SCHEDULER == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 1 ) )
+EDF_STATIC_ASSERT( sizeof( EDFStaticTask_t ) >= sizeof( TCB_t ), "EDFStaticTask_t smaller than the TCB" );
+#endif
+
 /*lint -save -e956 A manual analysis and inspection has been used to determine
  * which static variables must be declared volatile. */
 PRIVILEGED_DATA TCB_t * volatile pxCurrentTCB = NULL;
@@ -361,6 +444,77 @@ PRIVILEGED_DATA TCB_t * volatile pxCurrentTCB = NULL;
 #if (configUSE_EDF_SCHEDULER == 1)
 #define IDLE_PERIOD (TickType_t)100
 PRIVILEGED_DATA static List_t xReadyTasksListEDF; 											 /*< Ready tasks ordered by their deadline */
+PRIVILEGED_DATA static TCB_t * pxPeriodicTasks[ configEDF_MAX_PERIODIC_TASKS ];				 /*< Periodic tasks accepted by the admission test */
+PRIVILEGED_DATA static UBaseType_t uxPeriodicTaskCount = ( UBaseType_t ) 0U;
+
+/* Fixed point scale used by the admission test: a utilization of 1 is 10000 */
+#define edfUTILIZATION_SCALE ( ( uint32_t ) 10000UL )
+
+/* ucPeriodicState flags */
+#define edfDEACTIVATE_PENDING ( ( uint8_t ) 0x01U ) /*< Suspend the task when its current job ends */
+#define edfACTIVATED ( ( uint8_t ) 0x02U )          /*< Released by xTaskPeriodicActivate(), rebase the wake time */
+#define edfEVENT_DEADLINE ( ( uint8_t ) 0x04U )     /*< xJobDeadline holds the deadline of the job waiting on an event */
+
+#if (configUSE_EDF_STRIDE_BAND == 1)
+/* Band tasks wait behind every real-time job */
+#define prvEDFEventListKey( pxTCB ) ( ( ( pxTCB )->uxStrideTickets > ( UBaseType_t ) 0U ) ? portMAX_DELAY : listGET_LIST_ITEM_VALUE( &( ( pxTCB )->xStateListItem ) ) )
+#else
+#define prvEDFEventListKey( pxTCB ) listGET_LIST_ITEM_VALUE( &( ( pxTCB )->xStateListItem ) )
+#endif
+
+/* Called before blocking on an event, prvEDFRestoreJobDeadline() puts it back on wake or timeout */
+#define prvEDFSaveJobDeadline( pxTCB )																	\
+do {																									\
+	( pxTCB )->xJobDeadline = listGET_LIST_ITEM_VALUE( &( ( pxTCB )->xStateListItem ) );				\
+	( pxTCB )->ucPeriodicState |= edfEVENT_DEADLINE;													\
+} while( 0 )
+#endif
+
+#if (configUSE_EDF_STRIDE_BAND == 1)
+PRIVILEGED_DATA static List_t xReadyTasksListStride;							/*< Ready band tasks ordered by their pass */
+PRIVILEGED_DATA static TickType_t xStrideGlobalPass = ( TickType_t ) 0U;		/*< Smallest pass of the ready band tasks */
+PRIVILEGED_DATA static UBaseType_t uxStrideEpoch = ( UBaseType_t ) 0U;
+
+/* Stride of a task holding a single ticket */
+#define edfSTRIDE1 ( ( TickType_t ) 1UL << 16 )
+
+/* Passes are shifted back to 0 when the smallest one goes above this */
+#define edfSTRIDE_REBASE_THRESHOLD ( ( TickType_t ) 0x80000000UL )
+#endif
+
+#if (configUSE_EDF_TIME_TRIGGERED == 1)
+/* One slot of the dispatch table: the task owning the tick, NULL for a free tick */
+typedef struct xEDF_TT_SLOT
+{
+	TCB_t * pxTCB;
+	uint8_t ucJobEnd; /*< Last slot of the job, the task must not be ready after it */
+} EDFTTSlot_t;
+
+PRIVILEGED_DATA static EDFTTSlot_t xTTTable[ configEDF_TT_MAX_SLOTS ];	/*< Dispatch table over one hyperperiod */
+PRIVILEGED_DATA static UBaseType_t uxTTLength = ( UBaseType_t ) 0U;
+PRIVILEGED_DATA static UBaseType_t uxTTSlot = ( UBaseType_t ) 0U;			/*< Slot of the current tick */
+PRIVILEGED_DATA static volatile BaseType_t xTTActive = pdFALSE;			/*< pdFALSE: online EDF */
+
+/* The table only holds for the task set it was built from */
+#define prvEDFTaskSetChanged() ( xTTActive = pdFALSE )
+
+/* The slot of the current tick belongs to a ready job */
+#define prvEDFTTOwnerReady() ( ( xTTActive != pdFALSE ) && ( xTTTable[ uxTTSlot ].pxTCB != NULL ) &&						\
+	( listIS_CONTAINED_WITHIN( &xReadyTasksListEDF, &( xTTTable[ uxTTSlot ].pxTCB->xStateListItem ) ) != pdFALSE ) )
+
+/* Job to run: the owner of the slot, or the earliest deadline job when the slot is
+ * free or its job ended early */
+#define prvEDFSelectJob() ( prvEDFTTOwnerReady() ? xTTTable[ uxTTSlot ].pxTCB : ( TCB_t * ) listGET_OWNER_OF_HEAD_ENTRY( &xReadyTasksListEDF ) )
+#elif (configUSE_EDF_SCHEDULER == 1)
+#define prvEDFTaskSetChanged()
+#define prvEDFSelectJob() ( ( TCB_t * ) listGET_OWNER_OF_HEAD_ENTRY( &xReadyTasksListEDF ) )
+#endif
+
+#if (configUSE_EDF_LIMITED_PREEMPTION == 1)
+PRIVILEGED_DATA static volatile BaseType_t xPreemptionDeferred = pdFALSE; /*< An earlier deadline job is waiting for the running job to reach a preemption point */
+
+/* The task refuses preemption while it is inside a region that did not exceed its Q yet */
+#define prvEDFIsNonPreemptive( pxTCB ) ( ( ( pxTCB )->uxNPRNesting > ( UBaseType_t ) 0U ) && ( ( pxTCB )->xNPRTicks < ( pxTCB )->xTaskMaxNPR ) )
 #endif
 
 PRIVILEGED_DATA static List_t pxReadyTasksLists[ configMAX_PRIORITIES ]; /*< Prioritised ready tasks. */
@@ -577,6 +731,65 @@ static void prvInitialiseNewTask( TaskFunction_t pxTaskCode,
  */
 static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB ) PRIVILEGED_FUNCTION;
 
+// EDF code: admission control
+#if (configUSE_EDF_SCHEDULER == 1)
+
+/*
+ * Checks if the registered periodic tasks plus pxCandidate are schedulable by
+ * EDF, including the blocking added by non-preemptive regions.  Must be called
+ * from a critical section.
+ */
+static BaseType_t prvEDFAdmissionTest( const TCB_t * pxCandidate ) PRIVILEGED_FUNCTION;
+
+/*
+ * Removes a deleted task from the table used by the admission test.
+ */
+static void prvEDFUnregisterPeriodicTask( const TCB_t * pxTCB ) PRIVILEGED_FUNCTION;
+
+/*
+ * Returns pdTRUE if pxTCB was accepted by the admission test.
+ */
+static BaseType_t prvEDFIsRegistered( const TCB_t * pxTCB ) PRIVILEGED_FUNCTION;
+
+/*
+ * Gives a task leaving an event list the deadline its job had when it blocked,
+ * the delayed list overwrote it with the wake time.  Does nothing if the task
+ * was not waiting on an ordered event list.
+ */
+static void prvEDFRestoreJobDeadline( TCB_t * pxTCB ) PRIVILEGED_FUNCTION;
+
+/*
+ * Sets the timing parameters of a new task and runs the admission test, then
+ * adds the task to the ready list with its first absolute deadline.  Returns
+ * errEDF_TASK_NOT_SCHEDULABLE, without touching the ready list, if the test
+ * fails.  The caller owns the memory of a rejected task.
+ */
+static BaseType_t prvEDFAddNewTask( TCB_t * pxNewTCB,
+                                    TickType_t period,
+                                    TickType_t deadline,
+                                    TickType_t capacity,
+                                    TickType_t maxNPR ) PRIVILEGED_FUNCTION;
+
+#endif
+
+// EDF code: stride band
+#if (configUSE_EDF_STRIDE_BAND == 1)
+
+/*
+ * Inserts a band task in xReadyTasksListStride.  A task coming back from the
+ * Blocked or Suspended state starts from the current global pass, so it does
+ * not get credit for the time it did not use.
+ */
+static void prvStrideAddTaskToReadyList( TCB_t * pxTCB ) PRIVILEGED_FUNCTION;
+
+/*
+ * Charges the running band task for one tick.  Returns pdTRUE if another band
+ * task now has a smaller pass.
+ */
+static BaseType_t prvStrideChargeCurrentTask( void ) PRIVILEGED_FUNCTION;
+
+#endif
+
 /*
  * freertos_tasks_c_additions_init() should only be called if the user definable
  * macro FREERTOS_TASKS_C_ADDITIONS_INIT() is defined, as that is the only macro
@@ -600,12 +813,15 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB ) PRIVILEGED_FUNCTION;
                                     StackType_t * const puxStackBuffer,
                                     StaticTask_t * const pxTaskBuffer )
     {
+        #if (configUSE_EDF_SCHEDULER == 0)
         TCB_t * pxNewTCB;
+        #endif
         TaskHandle_t xReturn;
 
         configASSERT( puxStackBuffer != NULL );
         configASSERT( pxTaskBuffer != NULL );
 
+        // EDF code: the assert fails under EDF, the EDF fields do not fit in a StaticTask_t
         #if ( configASSERT_DEFINED == 1 )
             {
                 /* Sanity check that the size of the structure used to declare a
@@ -617,6 +833,10 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB ) PRIVILEGED_FUNCTION;
             }
         #endif /* configASSERT_DEFINED */
 
+        // EDF code: refused, static tasks are created by xTaskPeriodicCreateStatic() from an EDFStaticTask_t
+        #if (configUSE_EDF_SCHEDULER == 1)
+        xReturn = NULL;
+        #else
         if( ( pxTaskBuffer != NULL ) && ( puxStackBuffer != NULL ) )
         {
             /* The memory used for the task's TCB and stack are passed into this
@@ -639,10 +859,61 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB ) PRIVILEGED_FUNCTION;
         {
             xReturn = NULL;
         }
+        #endif /* configUSE_EDF_SCHEDULER */
 
         return xReturn;
     }
 
+	// EDF code: xTaskPeriodicCreateStatic()
+	#if (configUSE_EDF_SCHEDULER == 1)
+
+	BaseType_t xTaskPeriodicCreateStatic( TaskFunction_t pxTaskCode,
+	                                      const char * const pcName, /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
+	                                      const uint32_t ulStackDepth,
+	                                      void * const pvParameters,
+	                                      UBaseType_t uxPriority,
+	                                      TaskHandle_t * const pxCreatedTask,
+	                                      StackType_t * const puxStackBuffer,
+	                                      EDFStaticTask_t * const pxTaskBuffer,
+	                                      TickType_t period,
+	                                      TickType_t deadline,
+	                                      TickType_t capacity,
+	                                      TickType_t maxNPR )
+	{
+		TCB_t * pxNewTCB;
+		TaskHandle_t xHandle;
+		BaseType_t xReturn;
+
+		configASSERT( puxStackBuffer != NULL );
+		configASSERT( pxTaskBuffer != NULL );
+
+		/* The memory used for the task's TCB and stack are passed into this
+		 * function - use them. */
+		pxNewTCB = ( TCB_t * ) pxTaskBuffer; /*lint !e740 !e9087 Unusual cast is ok, the size of EDFStaticTask_t is checked at build time. */
+		pxNewTCB->pxStack = ( StackType_t * ) puxStackBuffer;
+
+		#if ( tskSTATIC_AND_DYNAMIC_ALLOCATION_POSSIBLE != 0 ) /*lint !e731 !e9029 Macro has been consolidated for readability reasons. */
+			{
+				pxNewTCB->ucStaticallyAllocated = tskSTATICALLY_ALLOCATED_STACK_AND_TCB;
+			}
+		#endif /* tskSTATIC_AND_DYNAMIC_ALLOCATION_POSSIBLE */
+
+		prvInitialiseNewTask( pxTaskCode, pcName, ulStackDepth, pvParameters, uxPriority, &xHandle, pxNewTCB, NULL );
+
+		xReturn = prvEDFAddNewTask( pxNewTCB, period, deadline, capacity, maxNPR );
+
+		if( pxCreatedTask != NULL )
+		{
+			/* Rejected by the admission test, the handle must not be used.  The
+			 * buffers are not in any list and can be reused. */
+			*pxCreatedTask = ( xReturn == pdPASS ) ? xHandle : NULL;
+		}
+
+		return xReturn;
+	}
+
+	#endif /* xTaskPeriodicCreateStatic() */
+
 #endif /* SUPPORT_STATIC_ALLOCATION */
 /*-----------------------------------------------------------*/
 
@@ -842,7 +1113,8 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB ) PRIVILEGED_FUNCTION;
                         const configSTACK_DEPTH_TYPE usStackDepth,
                         void * const pvParameters,
                         UBaseType_t uxPriority,
-                        TaskHandle_t * const pxCreatedTask, TickType_t period )
+                        TaskHandle_t * const pxCreatedTask, TickType_t period,
+                        TickType_t capacity, TickType_t maxNPR )
     {
         TCB_t * pxNewTCB;
         BaseType_t xReturn;
@@ -914,14 +1186,22 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB ) PRIVILEGED_FUNCTION;
             #endif /* tskSTATIC_AND_DYNAMIC_ALLOCATION_POSSIBLE */
 
             prvInitialiseNewTask( pxTaskCode, pcName, ( uint32_t ) usStackDepth, pvParameters, uxPriority, pxCreatedTask, pxNewTCB, NULL );
-						
-			// EDF code:
-			pxNewTCB->xTaskPeriod = period; /* Initialize the period */
-			/* Insert the period value in the xStateListItem before adding task to RL */
-			listSET_LIST_ITEM_VALUE(&(pxNewTCB->xStateListItem), pxNewTCB->xTaskPeriod + xTaskGetTickCount());
-					
-            prvAddNewTaskToReadyList( pxNewTCB );
-            xReturn = pdPASS;
+
+			// EDF code: implicit deadline, see xTaskPeriodicSetParameters()
+			xReturn = prvEDFAddNewTask( pxNewTCB, period, period, capacity, maxNPR );
+
+			if( xReturn != pdPASS )
+			{
+				/* Rejected by the admission test, the handle must not be used. */
+				if( pxCreatedTask != NULL )
+				{
+					*pxCreatedTask = NULL;
+				}
+
+				vPortFree( pxNewTCB->pxStack );
+				vPortFree( pxNewTCB );
+				xReturn = errEDF_TASK_NOT_SCHEDULABLE;
+			}
         }
         else
         {
@@ -937,6 +1217,851 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB ) PRIVILEGED_FUNCTION;
 #endif /* configSUPPORT_DYNAMIC_ALLOCATION */
 /*-----------------------------------------------------------*/
 
+// EDF code: admission control
+#if (configUSE_EDF_SCHEDULER == 1)
+
+	/* Picks the i-th task of the registered set extended with the candidate */
+	#define prvEDFCandidateSetEntry( uxIndex, pxCandidate ) ( ( ( uxIndex ) < uxPeriodicTaskCount ) ? pxPeriodicTasks[ ( uxIndex ) ] : ( pxCandidate ) )
+
+	static BaseType_t prvEDFIsRegistered( const TCB_t * pxTCB )
+	{
+		UBaseType_t uxIndex;
+
+		for( uxIndex = ( UBaseType_t ) 0U; uxIndex < uxPeriodicTaskCount; uxIndex++ )
+		{
+			if( pxPeriodicTasks[ uxIndex ] == pxTCB )
+			{
+				return pdTRUE;
+			}
+		}
+
+		return pdFALSE;
+	}
+	/*-----------------------------------------------------------*/
+
+	static BaseType_t prvEDFAdmissionTest( const TCB_t * pxCandidate )
+	{
+		const TCB_t * pxTaskK;
+		const TCB_t * pxTaskI;
+		UBaseType_t uxK, uxI, uxSetSize;
+		TickType_t xBlocking;
+		uint32_t ulDemand;
+
+		/* A registered candidate is tested with its current parameters, a new
+		 * one is appended to the set. */
+		uxSetSize = uxPeriodicTaskCount;
+
+		if( prvEDFIsRegistered( pxCandidate ) == pdFALSE )
+		{
+			if( uxPeriodicTaskCount >= ( UBaseType_t ) configEDF_MAX_PERIODIC_TASKS )
+			{
+				return pdFAIL;
+			}
+
+			uxSetSize++;
+		}
+
+		/* For every task k, the density of the tasks with a deadline not longer
+		 * than D(k) plus the longest non-preemptive region of a task with a longer
+		 * deadline must fit in D(k).  With implicit deadlines and no regions this
+		 * is the plain U <= 1 test.  Each term is rounded up so the test stays on
+		 * the safe side. */
+		for( uxK = ( UBaseType_t ) 0U; uxK < uxSetSize; uxK++ )
+		{
+			pxTaskK = prvEDFCandidateSetEntry( uxK, pxCandidate );
+			xBlocking = ( TickType_t ) 0U;
+			ulDemand = 0UL;
+
+			for( uxI = ( UBaseType_t ) 0U; uxI < uxSetSize; uxI++ )
+			{
+				pxTaskI = prvEDFCandidateSetEntry( uxI, pxCandidate );
+
+				if( pxTaskI->xTaskDeadline <= pxTaskK->xTaskDeadline )
+				{
+					ulDemand += ( ( pxTaskI->xTaskCapacity * edfUTILIZATION_SCALE ) + pxTaskI->xTaskDeadline - 1UL ) / pxTaskI->xTaskDeadline;
+				}
+				#if (configUSE_EDF_LIMITED_PREEMPTION == 1)
+				else if( pxTaskI->xTaskMaxNPR > xBlocking )
+				{
+					xBlocking = pxTaskI->xTaskMaxNPR;
+				}
+				#endif
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+
+			ulDemand += ( ( xBlocking * edfUTILIZATION_SCALE ) + pxTaskK->xTaskDeadline - 1UL ) / pxTaskK->xTaskDeadline;
+
+			if( ulDemand > edfUTILIZATION_SCALE )
+			{
+				return pdFAIL;
+			}
+		}
+
+		return pdPASS;
+	}
+	/*-----------------------------------------------------------*/
+
+	static void prvEDFUnregisterPeriodicTask( const TCB_t * pxTCB )
+	{
+		UBaseType_t uxIndex;
+
+		for( uxIndex = ( UBaseType_t ) 0U; uxIndex < uxPeriodicTaskCount; uxIndex++ )
+		{
+			if( pxPeriodicTasks[ uxIndex ] == pxTCB )
+			{
+				/* Keep the table packed, the order is irrelevant. */
+				uxPeriodicTaskCount--;
+				pxPeriodicTasks[ uxIndex ] = pxPeriodicTasks[ uxPeriodicTaskCount ];
+				prvEDFTaskSetChanged();
+				break;
+			}
+		}
+	}
+	/*-----------------------------------------------------------*/
+
+	static void prvEDFRestoreJobDeadline( TCB_t * pxTCB )
+	{
+		if( ( pxTCB->ucPeriodicState & edfEVENT_DEADLINE ) != 0U )
+		{
+			pxTCB->ucPeriodicState &= ( uint8_t ) ~edfEVENT_DEADLINE;
+			listSET_LIST_ITEM_VALUE( &( pxTCB->xStateListItem ), pxTCB->xJobDeadline );
+		}
+	}
+	/*-----------------------------------------------------------*/
+
+	static BaseType_t prvEDFAddNewTask( TCB_t * pxNewTCB,
+	                                    TickType_t period,
+	                                    TickType_t deadline,
+	                                    TickType_t capacity,
+	                                    TickType_t maxNPR )
+	{
+		BaseType_t xReturn = pdPASS;
+
+		/* Timing parameters used by the admission test */
+		configASSERT( ( deadline > ( TickType_t ) 0U ) && ( deadline <= period ) );
+		configASSERT( capacity <= deadline );
+		pxNewTCB->xTaskPeriod = period;
+		pxNewTCB->xTaskDeadline = deadline;
+		pxNewTCB->xTaskCapacity = capacity;
+		#if (configUSE_EDF_LIMITED_PREEMPTION == 1)
+		configASSERT( maxNPR <= capacity );
+		pxNewTCB->xTaskMaxNPR = maxNPR;
+		#else
+		( void ) maxNPR;
+		#endif
+
+		/* Tasks without a declared capacity (e.g. the idle task) are not
+		 * admission controlled. */
+		if( capacity > ( TickType_t ) 0U )
+		{
+			taskENTER_CRITICAL();
+			{
+				xReturn = prvEDFAdmissionTest( pxNewTCB );
+
+				if( xReturn == pdPASS )
+				{
+					pxPeriodicTasks[ uxPeriodicTaskCount ] = pxNewTCB;
+					uxPeriodicTaskCount++;
+					prvEDFTaskSetChanged();
+				}
+				else
+				{
+					xReturn = errEDF_TASK_NOT_SCHEDULABLE;
+				}
+			}
+			taskEXIT_CRITICAL();
+		}
+
+		if( xReturn == pdPASS )
+		{
+			/* Insert the deadline value in the xStateListItem before adding task to RL */
+			listSET_LIST_ITEM_VALUE( &( pxNewTCB->xStateListItem ), pxNewTCB->xTaskDeadline + xTaskGetTickCount() );
+
+			prvAddNewTaskToReadyList( pxNewTCB );
+		}
+
+		return xReturn;
+	}
+	/*-----------------------------------------------------------*/
+
+	BaseType_t xTaskPeriodicSetParameters( TaskHandle_t xTask,
+	                                       TickType_t period,
+	                                       TickType_t deadline,
+	                                       TickType_t capacity )
+	{
+		TCB_t * pxTCB;
+		TickType_t xOldPeriod, xOldDeadline, xOldCapacity;
+		BaseType_t xReturn;
+
+		configASSERT( ( deadline > ( TickType_t ) 0U ) && ( deadline <= period ) );
+		configASSERT( capacity <= deadline );
+
+		taskENTER_CRITICAL();
+		{
+			pxTCB = prvGetTCBFromHandle( xTask );
+
+			xOldPeriod = pxTCB->xTaskPeriod;
+			xOldDeadline = pxTCB->xTaskDeadline;
+			xOldCapacity = pxTCB->xTaskCapacity;
+
+			/* The absolute deadline of the job in progress is already in
+			 * xStateListItem, so the new values only take effect at the next
+			 * release, that is at the job boundary. */
+			pxTCB->xTaskPeriod = period;
+			pxTCB->xTaskDeadline = deadline;
+			pxTCB->xTaskCapacity = capacity;
+
+			if( capacity == ( TickType_t ) 0U )
+			{
+				prvEDFUnregisterPeriodicTask( pxTCB );
+				xReturn = pdPASS;
+			}
+			#if ( INCLUDE_vTaskSuspend == 1 )
+			else if( ( prvEDFIsRegistered( pxTCB ) == pdFALSE ) && ( prvTaskIsTaskSuspended( pxTCB ) != pdFALSE ) )
+			{
+				/* Deactivated task, it is tested by xTaskPeriodicActivate() */
+				xReturn = pdPASS;
+			}
+			#endif
+			else
+			{
+				xReturn = prvEDFAdmissionTest( pxTCB );
+
+				if( xReturn == pdPASS )
+				{
+					if( prvEDFIsRegistered( pxTCB ) == pdFALSE )
+					{
+						pxPeriodicTasks[ uxPeriodicTaskCount ] = pxTCB;
+						uxPeriodicTaskCount++;
+					}
+
+					prvEDFTaskSetChanged();
+				}
+				else
+				{
+					pxTCB->xTaskPeriod = xOldPeriod;
+					pxTCB->xTaskDeadline = xOldDeadline;
+					pxTCB->xTaskCapacity = xOldCapacity;
+					xReturn = errEDF_TASK_NOT_SCHEDULABLE;
+				}
+			}
+		}
+		taskEXIT_CRITICAL();
+
+		return xReturn;
+	}
+	/*-----------------------------------------------------------*/
+
+	TickType_t xTaskGetPeriod( TaskHandle_t xTask )
+	{
+		TickType_t xReturn;
+
+		taskENTER_CRITICAL();
+		{
+			xReturn = prvGetTCBFromHandle( xTask )->xTaskPeriod;
+		}
+		taskEXIT_CRITICAL();
+
+		return xReturn;
+	}
+	/*-----------------------------------------------------------*/
+
+	uint32_t ulTaskPeriodicGetUtilization( void )
+	{
+		UBaseType_t uxIndex;
+		uint32_t ulUtilization = 0UL;
+
+		taskENTER_CRITICAL();
+		{
+			/* Rounded up like the admission test */
+			for( uxIndex = ( UBaseType_t ) 0U; uxIndex < uxPeriodicTaskCount; uxIndex++ )
+			{
+				ulUtilization += ( ( pxPeriodicTasks[ uxIndex ]->xTaskCapacity * edfUTILIZATION_SCALE ) + pxPeriodicTasks[ uxIndex ]->xTaskPeriod - 1UL ) / pxPeriodicTasks[ uxIndex ]->xTaskPeriod;
+			}
+		}
+		taskEXIT_CRITICAL();
+
+		return ulUtilization;
+	}
+	/*-----------------------------------------------------------*/
+
+	#if ( INCLUDE_xTaskDelayUntil == 1 )
+
+		BaseType_t xTaskDelayUntilNextPeriod( TickType_t * const pxPreviousWakeTime )
+		{
+			#if ( INCLUDE_vTaskSuspend == 1 )
+			{
+				BaseType_t xDeactivate = pdFALSE;
+
+				taskENTER_CRITICAL();
+				{
+					/* The job that just ended was released by xTaskPeriodicActivate(),
+					 * its release time is the new reference for the wake times. */
+					if( ( pxCurrentTCB->ucPeriodicState & edfACTIVATED ) != 0U )
+					{
+						pxCurrentTCB->ucPeriodicState &= ( uint8_t ) ~edfACTIVATED;
+						*pxPreviousWakeTime = listGET_LIST_ITEM_VALUE( &( pxCurrentTCB->xStateListItem ) ) - pxCurrentTCB->xTaskDeadline;
+					}
+
+					/* A mode change asked this task to leave at the end of the job */
+					if( ( pxCurrentTCB->ucPeriodicState & edfDEACTIVATE_PENDING ) != 0U )
+					{
+						pxCurrentTCB->ucPeriodicState &= ( uint8_t ) ~edfDEACTIVATE_PENDING;
+						prvEDFUnregisterPeriodicTask( pxCurrentTCB );
+						xDeactivate = pdTRUE;
+					}
+				}
+				taskEXIT_CRITICAL();
+
+				if( xDeactivate != pdFALSE )
+				{
+					/* Returns when xTaskPeriodicActivate() releases the next job */
+					vTaskSuspend( NULL );
+					return pdTRUE;
+				}
+			}
+			#endif /* INCLUDE_vTaskSuspend */
+
+			/* Reading the period here, at the end of the job, is what makes a
+			 * period set by xTaskPeriodicSetParameters() apply from the next
+			 * release on. */
+			return xTaskDelayUntil( pxPreviousWakeTime, xTaskGetPeriod( NULL ) );
+		}
+
+	#endif /* INCLUDE_xTaskDelayUntil */
+	/*-----------------------------------------------------------*/
+
+	#if ( INCLUDE_vTaskSuspend == 1 )
+
+		void vTaskPeriodicDeactivate( TaskHandle_t xTask )
+		{
+			TCB_t * const pxTCB = xTask;
+			BaseType_t xSuspendNow = pdFALSE;
+
+			configASSERT( pxTCB != NULL );
+
+			taskENTER_CRITICAL();
+			{
+				/* A task that never ran, or that is waiting for its next release,
+				 * has no job in progress and can leave at once.  Otherwise it
+				 * leaves from xTaskDelayUntilNextPeriod() at the end of the job. */
+				if( ( xSchedulerRunning == pdFALSE ) ||
+					( ( listLIST_ITEM_CONTAINER( &( pxTCB->xEventListItem ) ) == NULL ) &&
+					  ( ( listIS_CONTAINED_WITHIN( pxDelayedTaskList, &( pxTCB->xStateListItem ) ) != pdFALSE ) ||
+						( listIS_CONTAINED_WITHIN( pxOverflowDelayedTaskList, &( pxTCB->xStateListItem ) ) != pdFALSE ) ) ) )
+				{
+					prvEDFUnregisterPeriodicTask( pxTCB );
+					xSuspendNow = pdTRUE;
+				}
+				else
+				{
+					pxTCB->ucPeriodicState |= edfDEACTIVATE_PENDING;
+				}
+			}
+			taskEXIT_CRITICAL();
+
+			if( xSuspendNow != pdFALSE )
+			{
+				vTaskSuspend( pxTCB );
+			}
+		}
+		/*-----------------------------------------------------------*/
+
+		BaseType_t xTaskPeriodicActivate( TaskHandle_t xTask )
+		{
+			TCB_t * const pxTCB = xTask;
+			BaseType_t xReturn = pdPASS;
+
+			configASSERT( ( pxTCB != NULL ) && ( pxTCB != pxCurrentTCB ) );
+
+			taskENTER_CRITICAL();
+			{
+				/* Still finishing its last job, keep it */
+				pxTCB->ucPeriodicState &= ( uint8_t ) ~edfDEACTIVATE_PENDING;
+
+				if( prvTaskIsTaskSuspended( pxTCB ) != pdFALSE )
+				{
+					if( ( pxTCB->xTaskCapacity > ( TickType_t ) 0U ) && ( prvEDFIsRegistered( pxTCB ) == pdFALSE ) )
+					{
+						xReturn = prvEDFAdmissionTest( pxTCB );
+
+						if( xReturn == pdPASS )
+						{
+							pxPeriodicTasks[ uxPeriodicTaskCount ] = pxTCB;
+							uxPeriodicTaskCount++;
+							prvEDFTaskSetChanged();
+						}
+						else
+						{
+							xReturn = errEDF_TASK_NOT_SCHEDULABLE;
+						}
+					}
+
+					if( xReturn == pdPASS )
+					{
+						/* The first job of the new activation is released now */
+						pxTCB->ucPeriodicState |= edfACTIVATED;
+						( void ) uxListRemove( &( pxTCB->xStateListItem ) );
+						listSET_LIST_ITEM_VALUE( &( pxTCB->xStateListItem ), xTickCount + pxTCB->xTaskDeadline );
+						prvAddTaskToReadyList( pxTCB );
+
+						if( ( xSchedulerRunning != pdFALSE ) &&
+							prvEDFRunsBefore( pxTCB, pxCurrentTCB ) )
+						{
+							taskYIELD_IF_USING_PREEMPTION();
+						}
+						else
+						{
+							mtCOVERAGE_TEST_MARKER();
+						}
+					}
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			taskEXIT_CRITICAL();
+
+			return xReturn;
+		}
+
+	#endif /* INCLUDE_vTaskSuspend */
+
+#endif /* configUSE_EDF_SCHEDULER */
+/*-----------------------------------------------------------*/
+
+// EDF code: time-triggered dispatch table
+#if (configUSE_EDF_TIME_TRIGGERED == 1)
+
+	/* Flags the last slot of every job so the tick can detect an overrun.
+	 * Jobs of a task with period T own the windows [ kT, (k + 1)T ). */
+	static void prvEDFTTMarkJobEnds( void )
+	{
+		UBaseType_t uxSlot, uxNext, uxWindowEnd;
+		TCB_t * pxTCB;
+
+		for( uxSlot = ( UBaseType_t ) 0U; uxSlot < uxTTLength; uxSlot++ )
+		{
+			pxTCB = xTTTable[ uxSlot ].pxTCB;
+			xTTTable[ uxSlot ].ucJobEnd = ( uint8_t ) 0U;
+
+			if( pxTCB != NULL )
+			{
+				uxWindowEnd = ( ( uxSlot / pxTCB->xTaskPeriod ) + 1U ) * pxTCB->xTaskPeriod;
+
+				for( uxNext = uxSlot + 1U; ( uxNext < uxWindowEnd ) && ( xTTTable[ uxNext ].pxTCB != pxTCB ); uxNext++ )
+				{
+				}
+
+				if( uxNext == uxWindowEnd )
+				{
+					xTTTable[ uxSlot ].ucJobEnd = ( uint8_t ) 1U;
+				}
+			}
+		}
+	}
+	/*-----------------------------------------------------------*/
+
+	BaseType_t xTaskTimeTriggeredBuild( void )
+	{
+		TickType_t xRemaining[ configEDF_MAX_PERIODIC_TASKS ];
+		TickType_t xDeadline[ configEDF_MAX_PERIODIC_TASKS ];
+		TickType_t xHyperperiod = ( TickType_t ) 1U, xA, xB, xTick;
+		UBaseType_t uxIndex, uxRun;
+		TCB_t * pxTCB;
+
+		/* The table is aligned with the first releases at tick 0 */
+		configASSERT( xSchedulerRunning == pdFALSE );
+
+		/* Hyperperiod: least common multiple of the periods */
+		for( uxIndex = ( UBaseType_t ) 0U; uxIndex < uxPeriodicTaskCount; uxIndex++ )
+		{
+			xA = xHyperperiod;
+			xB = pxPeriodicTasks[ uxIndex ]->xTaskPeriod;
+
+			while( xB != ( TickType_t ) 0U )
+			{
+				xTick = xA % xB;
+				xA = xB;
+				xB = xTick;
+			}
+
+			xHyperperiod = ( xHyperperiod / xA ) * pxPeriodicTasks[ uxIndex ]->xTaskPeriod;
+
+			if( xHyperperiod > ( TickType_t ) configEDF_TT_MAX_SLOTS )
+			{
+				return pdFAIL;
+			}
+
+			xRemaining[ uxIndex ] = ( TickType_t ) 0U;
+		}
+
+		/* EDF simulation with every job using its full capacity */
+		for( xTick = ( TickType_t ) 0U; xTick < xHyperperiod; xTick++ )
+		{
+			uxRun = uxPeriodicTaskCount;
+
+			for( uxIndex = ( UBaseType_t ) 0U; uxIndex < uxPeriodicTaskCount; uxIndex++ )
+			{
+				pxTCB = pxPeriodicTasks[ uxIndex ];
+
+				if( ( xTick % pxTCB->xTaskPeriod ) == ( TickType_t ) 0U )
+				{
+					if( xRemaining[ uxIndex ] > ( TickType_t ) 0U )
+					{
+						return pdFAIL;
+					}
+
+					xRemaining[ uxIndex ] = pxTCB->xTaskCapacity;
+					xDeadline[ uxIndex ] = xTick + pxTCB->xTaskDeadline;
+				}
+
+				if( xRemaining[ uxIndex ] > ( TickType_t ) 0U )
+				{
+					if( xDeadline[ uxIndex ] <= xTick )
+					{
+						return pdFAIL;
+					}
+
+					if( ( uxRun == uxPeriodicTaskCount ) || ( xDeadline[ uxIndex ] < xDeadline[ uxRun ] ) )
+					{
+						uxRun = uxIndex;
+					}
+				}
+			}
+
+			if( uxRun < uxPeriodicTaskCount )
+			{
+				xTTTable[ xTick ].pxTCB = pxPeriodicTasks[ uxRun ];
+				xRemaining[ uxRun ]--;
+			}
+			else
+			{
+				xTTTable[ xTick ].pxTCB = NULL;
+			}
+		}
+
+		for( uxIndex = ( UBaseType_t ) 0U; uxIndex < uxPeriodicTaskCount; uxIndex++ )
+		{
+			if( xRemaining[ uxIndex ] > ( TickType_t ) 0U )
+			{
+				return pdFAIL;
+			}
+		}
+
+		uxTTLength = ( UBaseType_t ) xHyperperiod;
+		uxTTSlot = ( UBaseType_t ) 0U;
+		prvEDFTTMarkJobEnds();
+		xTTActive = pdTRUE;
+
+		return pdPASS;
+	}
+	/*-----------------------------------------------------------*/
+
+	BaseType_t xTaskTimeTriggeredSetTable( const TaskHandle_t * pxTable,
+	                                       UBaseType_t uxLength )
+	{
+		UBaseType_t uxSlot;
+
+		configASSERT( xSchedulerRunning == pdFALSE );
+
+		if( ( uxLength == ( UBaseType_t ) 0U ) || ( uxLength > ( UBaseType_t ) configEDF_TT_MAX_SLOTS ) )
+		{
+			return pdFAIL;
+		}
+
+		for( uxSlot = ( UBaseType_t ) 0U; uxSlot < uxLength; uxSlot++ )
+		{
+			/* Only admitted tasks can own a slot and the table must span
+			 * whole periods of each of them */
+			if( ( pxTable[ uxSlot ] != NULL ) &&
+				( ( prvEDFIsRegistered( pxTable[ uxSlot ] ) == pdFALSE ) || ( ( uxLength % pxTable[ uxSlot ]->xTaskPeriod ) != 0U ) ) )
+			{
+				return pdFAIL;
+			}
+
+			xTTTable[ uxSlot ].pxTCB = pxTable[ uxSlot ];
+		}
+
+		uxTTLength = uxLength;
+		uxTTSlot = ( UBaseType_t ) 0U;
+		prvEDFTTMarkJobEnds();
+		xTTActive = pdTRUE;
+
+		return pdPASS;
+	}
+	/*-----------------------------------------------------------*/
+
+	BaseType_t xTaskTimeTriggeredIsActive( void )
+	{
+		return xTTActive;
+	}
+
+#endif /* configUSE_EDF_TIME_TRIGGERED */
+/*-----------------------------------------------------------*/
+
+// EDF code: stride band
+#if (configUSE_EDF_STRIDE_BAND == 1)
+
+	BaseType_t xTaskStrideCreate( TaskFunction_t pxTaskCode,
+	                              const char * const pcName, /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
+	                              const configSTACK_DEPTH_TYPE usStackDepth,
+	                              void * const pvParameters,
+	                              UBaseType_t uxTickets,
+	                              TaskHandle_t * const pxCreatedTask )
+	{
+		TCB_t * pxNewTCB;
+		BaseType_t xReturn;
+
+		configASSERT( ( uxTickets > ( UBaseType_t ) 0U ) && ( uxTickets <= ( UBaseType_t ) edfSTRIDE1 ) );
+
+        /* If the stack grows down then allocate the stack then the TCB so the stack
+         * does not grow into the TCB.  Likewise if the stack grows up then allocate
+         * the TCB then the stack. */
+        #if ( portSTACK_GROWTH > 0 )
+            {
+                /* Allocate space for the TCB.  Where the memory comes from depends on
+                 * the implementation of the port malloc function and whether or not static
+                 * allocation is being used. */
+                pxNewTCB = ( TCB_t * ) pvPortMalloc( sizeof( TCB_t ) );
+
+                if( pxNewTCB != NULL )
+                {
+                    /* Allocate space for the stack used by the task being created.
+                     * The base of the stack memory stored in the TCB so the task can
+                     * be deleted later if required. */
+                    pxNewTCB->pxStack = ( StackType_t * ) pvPortMalloc( ( ( ( size_t ) usStackDepth ) * sizeof( StackType_t ) ) ); /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
+
+                    if( pxNewTCB->pxStack == NULL )
+                    {
+                        /* Could not allocate the stack.  Delete the allocated TCB. */
+                        vPortFree( pxNewTCB );
+                        pxNewTCB = NULL;
+                    }
+                }
+            }
+        #else /* portSTACK_GROWTH */
+            {
+                StackType_t * pxStack;
+
+                /* Allocate space for the stack used by the task being created. */
+                pxStack = pvPortMalloc( ( ( ( size_t ) usStackDepth ) * sizeof( StackType_t ) ) ); /*lint !e9079 All values returned by pvPortMalloc() have at least the alignment required by the MCU's stack and this allocation is the stack. */
+
+                if( pxStack != NULL )
+                {
+                    /* Allocate space for the TCB. */
+                    pxNewTCB = ( TCB_t * ) pvPortMalloc( sizeof( TCB_t ) ); /*lint !e9087 !e9079 All values returned by pvPortMalloc() have at least the alignment required by the MCU's stack, and the first member of TCB_t is always a pointer to the task's stack. */
+
+                    if( pxNewTCB != NULL )
+                    {
+                        /* Store the stack location in the TCB. */
+                        pxNewTCB->pxStack = pxStack;
+                    }
+                    else
+                    {
+                        /* The stack cannot be used as the TCB was not created.  Free
+                         * it again. */
+                        vPortFree( pxStack );
+                    }
+                }
+                else
+                {
+                    pxNewTCB = NULL;
+                }
+            }
+        #endif /* portSTACK_GROWTH */
+
+		if( pxNewTCB != NULL )
+		{
+			#if ( tskSTATIC_AND_DYNAMIC_ALLOCATION_POSSIBLE != 0 ) /*lint !e9029 !e731 Macro has been consolidated for readability reasons. */
+				{
+					pxNewTCB->ucStaticallyAllocated = tskDYNAMICALLY_ALLOCATED_STACK_AND_TCB;
+				}
+			#endif /* tskSTATIC_AND_DYNAMIC_ALLOCATION_POSSIBLE */
+
+			/* The band sits below every real-time task, the idle priority keeps
+			 * the priority based yield decisions of the kernel consistent. */
+			prvInitialiseNewTask( pxTaskCode, pcName, ( uint32_t ) usStackDepth, pvParameters, tskIDLE_PRIORITY, pxCreatedTask, pxNewTCB, NULL );
+
+			pxNewTCB->uxStrideTickets = uxTickets;
+			pxNewTCB->xStride = edfSTRIDE1 / ( TickType_t ) uxTickets;
+
+			prvAddNewTaskToReadyList( pxNewTCB );
+			xReturn = pdPASS;
+		}
+		else
+		{
+			xReturn = errCOULD_NOT_ALLOCATE_REQUIRED_MEMORY;
+		}
+
+		return xReturn;
+	}
+	/*-----------------------------------------------------------*/
+
+	void vTaskStrideSetTickets( TaskHandle_t xTask,
+	                            UBaseType_t uxTickets )
+	{
+		TCB_t * pxTCB;
+
+		configASSERT( ( uxTickets > ( UBaseType_t ) 0U ) && ( uxTickets <= ( UBaseType_t ) edfSTRIDE1 ) );
+
+		taskENTER_CRITICAL();
+		{
+			pxTCB = prvGetTCBFromHandle( xTask );
+			configASSERT( pxTCB->uxStrideTickets > ( UBaseType_t ) 0U );
+
+			/* Takes effect from the next tick charged to the task */
+			pxTCB->uxStrideTickets = uxTickets;
+			pxTCB->xStride = edfSTRIDE1 / ( TickType_t ) uxTickets;
+		}
+		taskEXIT_CRITICAL();
+	}
+	/*-----------------------------------------------------------*/
+
+	static void prvStrideAddTaskToReadyList( TCB_t * pxTCB )
+	{
+		if( ( pxTCB->uxStrideEpoch != uxStrideEpoch ) || ( pxTCB->xStridePass < xStrideGlobalPass ) )
+		{
+			pxTCB->xStridePass = xStrideGlobalPass;
+			pxTCB->uxStrideEpoch = uxStrideEpoch;
+		}
+
+		listSET_LIST_ITEM_VALUE( &( pxTCB->xStateListItem ), pxTCB->xStridePass );
+		vListInsert( &xReadyTasksListStride, &( pxTCB->xStateListItem ) );
+	}
+	/*-----------------------------------------------------------*/
+
+	static BaseType_t prvStrideChargeCurrentTask( void )
+	{
+		ListItem_t const * pxEnd;
+		ListItem_t * pxItem;
+		TCB_t * pxTCB = pxCurrentTCB;
+
+		pxTCB->xStridePass += pxTCB->xStride;
+
+		/* The task may already have left the ready list when the tick was pended */
+		if( listIS_CONTAINED_WITHIN( &xReadyTasksListStride, &( pxTCB->xStateListItem ) ) != pdFALSE )
+		{
+			( void ) uxListRemove( &( pxTCB->xStateListItem ) );
+			listSET_LIST_ITEM_VALUE( &( pxTCB->xStateListItem ), pxTCB->xStridePass );
+			vListInsert( &xReadyTasksListStride, &( pxTCB->xStateListItem ) );
+		}
+
+		if( listLIST_IS_EMPTY( &xReadyTasksListStride ) != pdFALSE )
+		{
+			return pdFALSE;
+		}
+
+		xStrideGlobalPass = listGET_ITEM_VALUE_OF_HEAD_ENTRY( &xReadyTasksListStride );
+
+		/* Shift the ready passes back to 0, the order is unchanged.  Blocked
+		 * tasks see the new epoch and restart from the global pass. */
+		if( xStrideGlobalPass > edfSTRIDE_REBASE_THRESHOLD )
+		{
+			uxStrideEpoch++;
+			pxEnd = listGET_END_MARKER( &xReadyTasksListStride );
+
+			for( pxItem = listGET_HEAD_ENTRY( &xReadyTasksListStride ); pxItem != pxEnd; pxItem = listGET_NEXT( pxItem ) )
+			{
+				pxTCB = listGET_LIST_ITEM_OWNER( pxItem );
+				pxTCB->xStridePass -= xStrideGlobalPass;
+				pxTCB->uxStrideEpoch = uxStrideEpoch;
+				listSET_LIST_ITEM_VALUE( pxItem, pxTCB->xStridePass );
+			}
+
+			xStrideGlobalPass = ( TickType_t ) 0U;
+		}
+
+		return ( listGET_OWNER_OF_HEAD_ENTRY( &xReadyTasksListStride ) != pxCurrentTCB ) ? pdTRUE : pdFALSE;
+	}
+
+#endif /* configUSE_EDF_STRIDE_BAND */
+/*-----------------------------------------------------------*/
+
+// EDF code: limited preemption API
+#if (configUSE_EDF_LIMITED_PREEMPTION == 1)
+
+	void vTaskEnterNonPreemptiveRegion( void )
+	{
+		/* Only tasks that declared Q are accounted for by the admission test */
+		configASSERT( pxCurrentTCB->xTaskMaxNPR > ( TickType_t ) 0U );
+
+		taskENTER_CRITICAL();
+		{
+			if( pxCurrentTCB->uxNPRNesting == ( UBaseType_t ) 0U )
+			{
+				pxCurrentTCB->xNPRTicks = ( TickType_t ) 0U;
+			}
+
+			( pxCurrentTCB->uxNPRNesting )++;
+		}
+		taskEXIT_CRITICAL();
+	}
+	/*-----------------------------------------------------------*/
+
+	void vTaskExitNonPreemptiveRegion( void )
+	{
+		BaseType_t xYieldRequired = pdFALSE;
+
+		taskENTER_CRITICAL();
+		{
+			configASSERT( pxCurrentTCB->uxNPRNesting > ( UBaseType_t ) 0U );
+			( pxCurrentTCB->uxNPRNesting )--;
+
+			if( ( pxCurrentTCB->uxNPRNesting == ( UBaseType_t ) 0U ) && ( xPreemptionDeferred != pdFALSE ) )
+			{
+				xYieldRequired = pdTRUE;
+			}
+		}
+		taskEXIT_CRITICAL();
+
+		if( xYieldRequired != pdFALSE )
+		{
+			portYIELD_WITHIN_API();
+		}
+	}
+	/*-----------------------------------------------------------*/
+
+	void vTaskPreemptionPoint( void )
+	{
+		UBaseType_t uxNesting = ( UBaseType_t ) 0U;
+		BaseType_t xYieldRequired = pdFALSE;
+
+		taskENTER_CRITICAL();
+		{
+			if( xPreemptionDeferred != pdFALSE )
+			{
+				/* Leave the region so the switch is not refused again */
+				uxNesting = pxCurrentTCB->uxNPRNesting;
+				pxCurrentTCB->uxNPRNesting = ( UBaseType_t ) 0U;
+				xYieldRequired = pdTRUE;
+			}
+
+			/* The next chunk is measured from here */
+			pxCurrentTCB->xNPRTicks = ( TickType_t ) 0U;
+		}
+		taskEXIT_CRITICAL();
+
+		if( xYieldRequired != pdFALSE )
+		{
+			portYIELD_WITHIN_API();
+
+			taskENTER_CRITICAL();
+			{
+				pxCurrentTCB->uxNPRNesting = uxNesting;
+				pxCurrentTCB->xNPRTicks = ( TickType_t ) 0U;
+			}
+			taskEXIT_CRITICAL();
+		}
+	}
+
+#endif /* configUSE_EDF_LIMITED_PREEMPTION */
+/*-----------------------------------------------------------*/
+
 static void prvInitialiseNewTask( TaskFunction_t pxTaskCode,
                                   const char * const pcName, /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
                                   const uint32_t ulStackDepth,
@@ -1078,6 +2203,27 @@ static void prvInitialiseNewTask( TaskFunction_t pxTaskCode,
         }
     #endif /* configUSE_APPLICATION_TASK_TAG */
 
+	// EDF code: no timing parameters until xTaskPeriodicCreate() sets them
+	#if (configUSE_EDF_SCHEDULER == 1)
+		pxNewTCB->xTaskPeriod = ( TickType_t ) 0U;
+		pxNewTCB->xTaskDeadline = ( TickType_t ) 0U;
+		pxNewTCB->xTaskCapacity = ( TickType_t ) 0U;
+		pxNewTCB->ucPeriodicState = ( uint8_t ) 0U;
+	#endif
+
+	#if (configUSE_EDF_LIMITED_PREEMPTION == 1)
+		pxNewTCB->xTaskMaxNPR = ( TickType_t ) 0U;
+		pxNewTCB->uxNPRNesting = ( UBaseType_t ) 0U;
+		pxNewTCB->xNPRTicks = ( TickType_t ) 0U;
+	#endif
+
+	#if (configUSE_EDF_STRIDE_BAND == 1)
+		pxNewTCB->uxStrideTickets = ( UBaseType_t ) 0U;
+		pxNewTCB->xStride = ( TickType_t ) 0U;
+		pxNewTCB->xStridePass = ( TickType_t ) 0U;
+		pxNewTCB->uxStrideEpoch = ( UBaseType_t ) 0U;
+	#endif
+
     #if ( configGENERATE_RUN_TIME_STATS == 1 )
         {
             pxNewTCB->ulRunTimeCounter = 0UL;
@@ -1232,7 +2378,7 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB )
                         mtCOVERAGE_TEST_MARKER();
                     }
 				#else
-				    if( pxCurrentTCB->xStateListItem.xItemValue > pxNewTCB->xStateListItem.xItemValue )
+				    if( !prvEDFRunsBefore( pxCurrentTCB, pxNewTCB ) )
                     {
                         pxCurrentTCB = pxNewTCB;
                     }
@@ -1316,6 +2462,11 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB )
                 mtCOVERAGE_TEST_MARKER();
             }
 
+			// EDF code: a deleted task no longer takes part in the admission test
+			#if (configUSE_EDF_SCHEDULER == 1)
+			prvEDFUnregisterPeriodicTask( pxTCB );
+			#endif
+
             /* Increment the uxTaskNumber also so kernel aware debuggers can
              * detect that the task lists need re-generating.  This is done before
              * portPRE_TASK_DELETE_HOOK() as in the Windows port that macro will
@@ -1779,7 +2930,7 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB )
 
                 /* Only reset the event list item value if the value is not
                  * being used for anything else. */
-                if( ( listGET_LIST_ITEM_VALUE( &( pxTCB->xEventListItem ) ) & taskEVENT_LIST_ITEM_VALUE_IN_USE ) == 0UL )
+                if( prvEventItemValueIsFree( pxTCB ) )
                 {
                     listSET_LIST_ITEM_VALUE( &( pxTCB->xEventListItem ), ( ( TickType_t ) configMAX_PRIORITIES - ( TickType_t ) uxNewPriority ) ); /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
                 }
@@ -2126,13 +3277,34 @@ void vTaskStartScheduler( void )
     /* Add the idle task at the lowest priority. */
     #if ( configSUPPORT_STATIC_ALLOCATION == 1 )
         {
-            StaticTask_t * pxIdleTaskTCBBuffer = NULL;
             StackType_t * pxIdleTaskStackBuffer = NULL;
             uint32_t ulIdleTaskStackSize;
 
+			// EDF code: Initialize IDLE task, in an EDFStaticTask_t from the EDF idle memory hook
+			#if (configUSE_EDF_SCHEDULER == 1)
+			EDFStaticTask_t * pxIdleTaskTCBBuffer = NULL;
+
+			vApplicationGetEDFIdleTaskMemory( &pxIdleTaskTCBBuffer, &pxIdleTaskStackBuffer, &ulIdleTaskStackSize );
+
+			( void ) xTaskPeriodicCreateStatic( prvIdleTask,
+			                                    configIDLE_TASK_NAME,
+			                                    ulIdleTaskStackSize,
+			                                    ( void * ) NULL,
+			                                    portPRIVILEGE_BIT, /* In effect ( tskIDLE_PRIORITY | portPRIVILEGE_BIT ), but tskIDLE_PRIORITY is zero. */
+			                                    &xIdleTaskHandle,
+			                                    pxIdleTaskStackBuffer,
+			                                    pxIdleTaskTCBBuffer,
+			                                    IDLE_PERIOD,
+			                                    IDLE_PERIOD,
+			                                    ( TickType_t ) 0U,  /* No capacity, the idle task is not admission controlled. */
+			                                    ( TickType_t ) 0U); /* Fully preemptive. */
+			#else
+            StaticTask_t * pxIdleTaskTCBBuffer = NULL;
+
             /* The Idle task is created using user provided RAM - obtain the
              * address of the RAM then create the idle task. */
             vApplicationGetIdleTaskMemory( &pxIdleTaskTCBBuffer, &pxIdleTaskStackBuffer, &ulIdleTaskStackSize );
+
             xIdleTaskHandle = xTaskCreateStatic( prvIdleTask,
                                                  configIDLE_TASK_NAME,
                                                  ulIdleTaskStackSize,
@@ -2140,6 +3312,7 @@ void vTaskStartScheduler( void )
                                                  portPRIVILEGE_BIT,     /* In effect ( tskIDLE_PRIORITY | portPRIVILEGE_BIT ), but tskIDLE_PRIORITY is zero. */
                                                  pxIdleTaskStackBuffer,
                                                  pxIdleTaskTCBBuffer ); /*lint !e961 MISRA exception, justified as it is not a redundant explicit cast to all supported compilers. */
+			#endif
 
             if( xIdleTaskHandle != NULL )
             {
@@ -2163,7 +3336,9 @@ void vTaskStartScheduler( void )
                         ( void * ) NULL,
                         portPRIVILEGE_BIT,  /* In effect ( tskIDLE_PRIORITY | portPRIVILEGE_BIT ), but tskIDLE_PRIORITY is zero. */
                         &xIdleTaskHandle, /*lint !e961 MISRA exception, justified as it is not a redundant explicit cast to all supported compilers. */
-						IDLE_PERIOD);
+						IDLE_PERIOD,
+						( TickType_t ) 0U,  /* No capacity, the idle task is not admission controlled. */
+						( TickType_t ) 0U); /* Fully preemptive. */
 			#else
             xReturn = xTaskCreate( prvIdleTask,
                                    configIDLE_TASK_NAME,
@@ -2384,11 +3559,19 @@ BaseType_t xTaskResumeAll( void )
                     pxTCB = listGET_OWNER_OF_HEAD_ENTRY( ( &xPendingReadyList ) ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
                     ( void ) uxListRemove( &( pxTCB->xEventListItem ) );
                     ( void ) uxListRemove( &( pxTCB->xStateListItem ) );
+					#if (configUSE_EDF_SCHEDULER == 1)
+						prvEDFRestoreJobDeadline( pxTCB );
+					#endif
                     prvAddTaskToReadyList( pxTCB );
 
                     /* If the moved task has a priority higher than the current
                      * task then a yield must be performed. */
+					// EDF code: compare deadlines instead
+					#if (configUSE_EDF_SCHEDULER == 1)
+                    if( prvEDFRunsBefore( pxTCB, pxCurrentTCB ) )
+					#else
                     if( pxTCB->uxPriority >= pxCurrentTCB->uxPriority )
+					#endif
                     {
                         xYieldPending = pdTRUE;
                     }
@@ -2822,6 +4005,10 @@ BaseType_t xTaskCatchUpTicks( TickType_t xTicksToCatchUp )
                     {
                         ( void ) uxListRemove( &( pxTCB->xEventListItem ) );
 
+						#if (configUSE_EDF_SCHEDULER == 1)
+							prvEDFRestoreJobDeadline( pxTCB );
+						#endif
+
                         /* This lets the task know it was forcibly removed from the
                          * blocked state so it should not re-evaluate its block time and
                          * then block again. */
@@ -2900,6 +4087,31 @@ BaseType_t xTaskIncrementTick( void )
             mtCOVERAGE_TEST_MARKER();
         }
 
+		// EDF code: a job still ready after its last slot overran, fall back to online EDF
+		#if (configUSE_EDF_TIME_TRIGGERED == 1)
+		if( xTTActive != pdFALSE )
+		{
+			/* Checked before this tick's releases so a new job is not taken for an overrun */
+			if( ( xTTTable[ uxTTSlot ].ucJobEnd != ( uint8_t ) 0U ) &&
+				( listIS_CONTAINED_WITHIN( &xReadyTasksListEDF, &( xTTTable[ uxTTSlot ].pxTCB->xStateListItem ) ) != pdFALSE ) )
+			{
+				xTTActive = pdFALSE;
+			}
+			else
+			{
+				uxTTSlot = ( uxTTSlot + 1U == uxTTLength ) ? ( UBaseType_t ) 0U : uxTTSlot + 1U;
+			}
+		}
+		#endif
+
+		// EDF code: measure the length of the running non-preemptive region
+		#if (configUSE_EDF_LIMITED_PREEMPTION == 1)
+		if( pxCurrentTCB->uxNPRNesting > ( UBaseType_t ) 0U )
+		{
+			( pxCurrentTCB->xNPRTicks )++;
+		}
+		#endif
+
         /* See if this tick has made a timeout expire.  Tasks are stored in
          * the  queue in the order of their wake time - meaning once one task
          * has been found whose block time has not expired there is no need to
@@ -2945,6 +4157,19 @@ BaseType_t xTaskIncrementTick( void )
                     /* It is time to remove the item from the Blocked state. */
                     ( void ) uxListRemove( &( pxTCB->xStateListItem ) );
 
+					// EDF code: a wait that timed out resumes the same job, a delay that ended releases a new one
+					#if (configUSE_EDF_SCHEDULER == 1)
+					if( listLIST_ITEM_CONTAINER( &( pxTCB->xEventListItem ) ) != NULL )
+					{
+						prvEDFRestoreJobDeadline( pxTCB );
+					}
+					else
+					{
+						pxTCB->ucPeriodicState &= ( uint8_t ) ~edfEVENT_DEADLINE;
+						listSET_LIST_ITEM_VALUE(&(pxTCB->xStateListItem), pxTCB->xTaskDeadline + listGET_LIST_ITEM_VALUE(&(pxTCB->xStateListItem)));
+					}
+					#endif
+
                     /* Is the task waiting on an event also?  If so remove
                      * it from the event list. */
                     if( listLIST_ITEM_CONTAINER( &( pxTCB->xEventListItem ) ) != NULL )
@@ -2956,12 +4181,6 @@ BaseType_t xTaskIncrementTick( void )
                         mtCOVERAGE_TEST_MARKER();
                     }
 										
-					// EDF code: update task new deadline before adding to ready list
-					#if (configUSE_EDF_SCHEDULER == 1)
-						listSET_LIST_ITEM_VALUE(&(pxTCB->xStateListItem), pxTCB->xTaskPeriod + listGET_LIST_ITEM_VALUE(&(pxTCB->xStateListItem)));
-						//pxTCB->xStateListItem.xItemValue = xItemValue + pxTCB->xTaskPeriod;
-					#endif
-										
                     /* Place the unblocked task into the appropriate ready
                      * list. */
                     prvAddTaskToReadyList( pxTCB );
@@ -2977,9 +4196,19 @@ BaseType_t xTaskIncrementTick( void )
 													
 							// EDF code: Preemtion decision based on deadline not priority
 							#if (configUSE_EDF_SCHEDULER == 1)
-							    if( listGET_LIST_ITEM_VALUE(&(pxTCB->xStateListItem)) <= listGET_LIST_ITEM_VALUE(&(pxCurrentTCB->xStateListItem)) )
+							    if( prvEDFRunsBefore( pxTCB, pxCurrentTCB ) )
                                 {
-                                    xSwitchRequired = pdTRUE;
+									// EDF code: a job inside a non-preemptive region is preempted at its next preemption point
+									#if (configUSE_EDF_LIMITED_PREEMPTION == 1)
+									if( prvEDFIsNonPreemptive( pxCurrentTCB ) )
+									{
+										xPreemptionDeferred = pdTRUE;
+									}
+									else
+									#endif
+									{
+										xSwitchRequired = pdTRUE;
+									}
                                 }
                                 else
                                 {
@@ -3017,6 +4246,53 @@ BaseType_t xTaskIncrementTick( void )
             }
         #endif /* ( ( configUSE_PREEMPTION == 1 ) && ( configUSE_TIME_SLICING == 1 ) ) */
 
+		// EDF code: grant a deferred preemption once the region ended or ran past Q
+		#if (configUSE_EDF_LIMITED_PREEMPTION == 1)
+		if( ( xPreemptionDeferred != pdFALSE ) && ( !prvEDFIsNonPreemptive( pxCurrentTCB ) ) )
+		{
+			xSwitchRequired = pdTRUE;
+		}
+		#endif
+
+		// EDF code: round robin of the band by pass
+		#if (configUSE_EDF_STRIDE_BAND == 1)
+		if( pxCurrentTCB->uxStrideTickets > ( UBaseType_t ) 0U )
+		{
+			if( prvStrideChargeCurrentTask() != pdFALSE )
+			{
+				xSwitchRequired = pdTRUE;
+			}
+		}
+		else if( ( pxCurrentTCB == xIdleTaskHandle ) && ( listLIST_IS_EMPTY( &xReadyTasksListStride ) == pdFALSE ) )
+		{
+			/* A band task became ready without a yield */
+			xSwitchRequired = pdTRUE;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+		#endif
+
+		// EDF code: the slot belongs to a ready job other than the running one, free
+		// slots and slots of a job that ended early leave the CPU to online EDF
+		#if (configUSE_EDF_TIME_TRIGGERED == 1)
+		if( prvEDFTTOwnerReady() && ( xTTTable[ uxTTSlot ].pxTCB != pxCurrentTCB ) )
+		{
+			#if (configUSE_EDF_LIMITED_PREEMPTION == 1)
+			if( prvEDFIsNonPreemptive( pxCurrentTCB ) )
+			{
+				/* The owner waits for the end of the region like an earlier deadline */
+				xPreemptionDeferred = pdTRUE;
+			}
+			else
+			#endif
+			{
+				xSwitchRequired = pdTRUE;
+			}
+		}
+		#endif
+
         #if ( configUSE_TICK_HOOK == 1 )
             {
                 /* Guard against the tick hook being called when the pended tick
@@ -3058,6 +4334,8 @@ BaseType_t xTaskIncrementTick( void )
         #endif
     }
 
+	traceTASK_INCREMENT_TICK_EXIT();
+
     return xSwitchRequired;
 }
 /*-----------------------------------------------------------*/
@@ -3176,6 +4454,8 @@ BaseType_t xTaskIncrementTick( void )
 
 void vTaskSwitchContext( void )
 {
+	traceTASK_SWITCH_CONTEXT_ENTER();
+
     if( uxSchedulerSuspended != ( UBaseType_t ) pdFALSE )
     {
         /* The scheduler is currently suspended - do not allow a context
@@ -3232,7 +4512,41 @@ void vTaskSwitchContext( void )
 		#if (configUSE_EDF_SCHEDULER == 0)
         taskSELECT_HIGHEST_PRIORITY_TASK(); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
         #else
-		pxCurrentTCB = (TCB_t *) listGET_OWNER_OF_HEAD_ENTRY(&xReadyTasksListEDF);
+		// EDF code: a job inside a non-preemptive region keeps the CPU as long as it is ready,
+		// even against the owner of a time-triggered slot
+		#if (configUSE_EDF_LIMITED_PREEMPTION == 1)
+		if( prvEDFIsNonPreemptive( pxCurrentTCB ) && ( listIS_CONTAINED_WITHIN( &xReadyTasksListEDF, &( pxCurrentTCB->xStateListItem ) ) != pdFALSE ) )
+		{
+			if( prvEDFSelectJob() != pxCurrentTCB )
+			{
+				xPreemptionDeferred = pdTRUE;
+			}
+		}
+		else
+		{
+			TCB_t * pxJobTCB = prvEDFSelectJob();
+
+			if( pxJobTCB != pxCurrentTCB )
+			{
+				pxCurrentTCB = pxJobTCB;
+
+				/* A region resumed after a switch starts a new chunk */
+				pxCurrentTCB->xNPRTicks = ( TickType_t ) 0U;
+			}
+
+			xPreemptionDeferred = pdFALSE;
+		}
+		#else
+		pxCurrentTCB = prvEDFSelectJob();
+		#endif
+
+		// EDF code: the band gets the CPU when the idle task is the only ready EDF task
+		#if (configUSE_EDF_STRIDE_BAND == 1)
+		if( ( listCURRENT_LIST_LENGTH( &xReadyTasksListEDF ) <= ( UBaseType_t ) 1U ) && ( listLIST_IS_EMPTY( &xReadyTasksListStride ) == pdFALSE ) )
+		{
+			pxCurrentTCB = (TCB_t *) listGET_OWNER_OF_HEAD_ENTRY(&xReadyTasksListStride);
+		}
+		#endif
 		#endif
 				
 		traceTASK_SWITCHED_IN();
@@ -3254,6 +4568,8 @@ void vTaskSwitchContext( void )
             }
         #endif /* configUSE_NEWLIB_REENTRANT */
     }
+
+	traceTASK_SWITCH_CONTEXT_EXIT();
 }
 /*-----------------------------------------------------------*/
 
@@ -3269,6 +4585,11 @@ void vTaskPlaceOnEventList( List_t * const pxEventList,
      * This is placed in the list in priority order so the highest priority task
      * is the first to be woken by the event.  The queue that contains the event
      * list is locked, preventing simultaneous access from interrupts. */
+	// EDF code: waiters are ordered by the deadline of their job instead
+	#if (configUSE_EDF_SCHEDULER == 1)
+		listSET_LIST_ITEM_VALUE( &( pxCurrentTCB->xEventListItem ), prvEDFEventListKey( pxCurrentTCB ) );
+		prvEDFSaveJobDeadline( pxCurrentTCB );
+	#endif
     vListInsert( pxEventList, &( pxCurrentTCB->xEventListItem ) );
 
     prvAddCurrentTaskToDelayedList( xTicksToWait, pdTRUE );
@@ -3290,6 +4611,11 @@ void vTaskPlaceOnUnorderedEventList( List_t * pxEventList,
      * task that is not in the Blocked state. */
     listSET_LIST_ITEM_VALUE( &( pxCurrentTCB->xEventListItem ), xItemValue | taskEVENT_LIST_ITEM_VALUE_IN_USE );
 
+	// EDF code: the value holds event bits, the job deadline is kept aside
+	#if (configUSE_EDF_SCHEDULER == 1)
+		prvEDFSaveJobDeadline( pxCurrentTCB );
+	#endif
+
     /* Place the event list item of the TCB at the end of the appropriate event
      * list.  It is safe to access the event list here because it is part of an
      * event group implementation - and interrupts don't access event groups
@@ -3319,6 +4645,10 @@ void vTaskPlaceOnUnorderedEventList( List_t * pxEventList,
          * In this case it is assume that this is the only task that is going to
          * be waiting on this event list, so the faster vListInsertEnd() function
          * can be used in place of vListInsert. */
+		#if (configUSE_EDF_SCHEDULER == 1)
+			listSET_LIST_ITEM_VALUE( &( pxCurrentTCB->xEventListItem ), prvEDFEventListKey( pxCurrentTCB ) );
+			prvEDFSaveJobDeadline( pxCurrentTCB );
+		#endif
         vListInsertEnd( pxEventList, &( pxCurrentTCB->xEventListItem ) );
 
         /* If the task should block indefinitely then set the block time to a
@@ -3361,6 +4691,9 @@ BaseType_t xTaskRemoveFromEventList( const List_t * const pxEventList )
     if( uxSchedulerSuspended == ( UBaseType_t ) pdFALSE )
     {
         ( void ) uxListRemove( &( pxUnblockedTCB->xStateListItem ) );
+		#if (configUSE_EDF_SCHEDULER == 1)
+			prvEDFRestoreJobDeadline( pxUnblockedTCB );
+		#endif
         prvAddTaskToReadyList( pxUnblockedTCB );
 
         #if ( configUSE_TICKLESS_IDLE != 0 )
@@ -3384,7 +4717,12 @@ BaseType_t xTaskRemoveFromEventList( const List_t * const pxEventList )
         vListInsertEnd( &( xPendingReadyList ), &( pxUnblockedTCB->xEventListItem ) );
     }
 
+	// EDF code: wake decision based on deadline not priority
+	#if (configUSE_EDF_SCHEDULER == 1)
+    if( prvEDFRunsBefore( pxUnblockedTCB, pxCurrentTCB ) )
+	#else
     if( pxUnblockedTCB->uxPriority > pxCurrentTCB->uxPriority )
+	#endif
     {
         /* Return true if the task removed from the event list has a higher
          * priority than the calling task.  This allows the calling task to know if
@@ -3440,9 +4778,17 @@ void vTaskRemoveFromUnorderedEventList( ListItem_t * pxEventListItem,
      * scheduler is suspended so interrupts will not be accessing the ready
      * lists. */
     ( void ) uxListRemove( &( pxUnblockedTCB->xStateListItem ) );
+	#if (configUSE_EDF_SCHEDULER == 1)
+		prvEDFRestoreJobDeadline( pxUnblockedTCB );
+	#endif
     prvAddTaskToReadyList( pxUnblockedTCB );
 
+	// EDF code: wake decision based on deadline not priority
+	#if (configUSE_EDF_SCHEDULER == 1)
+    if( prvEDFRunsBefore( pxUnblockedTCB, pxCurrentTCB ) )
+	#else
     if( pxUnblockedTCB->uxPriority > pxCurrentTCB->uxPriority )
+	#endif
     {
         /* The unblocked task has a priority above that of the calling task, so
          * a context switch is required.  This function is called with the
@@ -3835,6 +5181,9 @@ static void prvInitialiseTaskLists( void )
 	#if (configUSE_EDF_SCHEDULER == 1)
 	vListInitialise(&xReadyTasksListEDF);
 	#endif
+	#if (configUSE_EDF_STRIDE_BAND == 1)
+	vListInitialise(&xReadyTasksListStride);
+	#endif
 
     vListInitialise( &xDelayedTaskList1 );
     vListInitialise( &xDelayedTaskList2 );
@@ -4253,7 +5602,7 @@ static void prvResetNextTaskUnblockTime( void )
                 /* Adjust the mutex holder state to account for its new
                  * priority.  Only reset the event list item value if the value is
                  * not being used for anything else. */
-                if( ( listGET_LIST_ITEM_VALUE( &( pxMutexHolderTCB->xEventListItem ) ) & taskEVENT_LIST_ITEM_VALUE_IN_USE ) == 0UL )
+                if( prvEventItemValueIsFree( pxMutexHolderTCB ) )
                 {
                     listSET_LIST_ITEM_VALUE( &( pxMutexHolderTCB->xEventListItem ), ( TickType_t ) configMAX_PRIORITIES - ( TickType_t ) pxCurrentTCB->uxPriority ); /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
                 }
@@ -4454,7 +5803,7 @@ static void prvResetNextTaskUnblockTime( void )
 
                     /* Only reset the event list item value if the value is not
                      * being used for anything else. */
-                    if( ( listGET_LIST_ITEM_VALUE( &( pxTCB->xEventListItem ) ) & taskEVENT_LIST_ITEM_VALUE_IN_USE ) == 0UL )
+                    if( prvEventItemValueIsFree( pxTCB ) )
                     {
                         listSET_LIST_ITEM_VALUE( &( pxTCB->xEventListItem ), ( TickType_t ) configMAX_PRIORITIES - ( TickType_t ) uxPriorityToUse ); /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
                     }
@@ -0,0 +1,144 @@
+/*
+ * GPIO input event service, see input_service.h.
+ */
+
+/* Scheduler includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+
+#include "input_service.h"
+
+// Type definitions
+typedef struct
+{
+	portX_t xPort;
+	pinX_t xPin;
+	pinState_t xStableState; // Last reported state
+	TickType_t xChangeTime; // First sample of the pending state
+	uint8_t ucStableCount; // Samples in a row that differ from xStableState
+	UBaseType_t uxSubscriberCount;
+	QueueHandle_t xSubscribers[ INPUT_MAX_SUBSCRIBERS ];
+	uint8_t ucInputIds[ INPUT_MAX_SUBSCRIBERS ];
+} InputPin_st;
+
+// Global Variables
+static InputPin_st xInputPins[ INPUT_MAX_PINS ];
+static UBaseType_t uxInputPinCount = 0;
+static uint32_t ulInputLostCount = 0;
+
+// Prototypes
+static void prvInputPost( InputPin_st *pxPin, TickType_t xTimeStamp );
+
+/*-----------------------------------------------------------*/
+
+static void prvInputPost( InputPin_st *pxPin, TickType_t xTimeStamp )
+{
+	InputEvent_st xEvent;
+	UBaseType_t uxIndex;
+	BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+	xEvent.xState = pxPin->xStableState;
+	xEvent.xTimeStamp = xTimeStamp;
+
+	for( uxIndex = 0; uxIndex < pxPin->uxSubscriberCount; uxIndex++ )
+	{
+		xEvent.ucInputId = pxPin->ucInputIds[ uxIndex ];
+
+		// From the tick hook the switch to a woken task happens on the way
+		// out of the tick interrupt, nothing to do with the flag here
+		if( xQueueSendFromISR( pxPin->xSubscribers[ uxIndex ], &xEvent, &xHigherPriorityTaskWoken ) != pdTRUE )
+		{
+			ulInputLostCount++;
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xInputServiceSubscribe( portX_t xPort,
+                                   pinX_t xPin,
+                                   uint8_t ucInputId,
+                                   QueueHandle_t xSubscriber )
+{
+	InputPin_st *pxPin = NULL;
+	UBaseType_t uxIndex;
+	BaseType_t xReturn = pdFAIL;
+
+	configASSERT( xSubscriber != NULL );
+
+	// The tick hook walks the table
+	taskENTER_CRITICAL();
+	{
+		for( uxIndex = 0; uxIndex < uxInputPinCount; uxIndex++ )
+		{
+			if( ( xInputPins[ uxIndex ].xPort == xPort ) && ( xInputPins[ uxIndex ].xPin == xPin ) )
+			{
+				pxPin = &xInputPins[ uxIndex ];
+				break;
+			}
+		}
+
+		if( ( pxPin == NULL ) && ( uxInputPinCount < INPUT_MAX_PINS ) )
+		{
+			pxPin = &xInputPins[ uxInputPinCount ];
+			pxPin->xPort = xPort;
+			pxPin->xPin = xPin;
+			pxPin->xStableState = GPIO_read( xPort, xPin );
+			pxPin->ucStableCount = 0;
+			pxPin->uxSubscriberCount = 0;
+			uxInputPinCount++;
+		}
+
+		if( ( pxPin != NULL ) && ( pxPin->uxSubscriberCount < INPUT_MAX_SUBSCRIBERS ) )
+		{
+			pxPin->xSubscribers[ pxPin->uxSubscriberCount ] = xSubscriber;
+			pxPin->ucInputIds[ pxPin->uxSubscriberCount ] = ucInputId;
+			pxPin->uxSubscriberCount++;
+			xReturn = pdPASS;
+		}
+	}
+	taskEXIT_CRITICAL();
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vInputServiceScanFromISR( void )
+{
+	InputPin_st *pxPin;
+	UBaseType_t uxIndex;
+	TickType_t xNow = xTaskGetTickCountFromISR();
+
+	for( uxIndex = 0; uxIndex < uxInputPinCount; uxIndex++ )
+	{
+		pxPin = &xInputPins[ uxIndex ];
+
+		if( GPIO_read( pxPin->xPort, pxPin->xPin ) == pxPin->xStableState )
+		{
+			// Bounce or no change, start over
+			pxPin->ucStableCount = 0;
+			continue;
+		}
+
+		if( pxPin->ucStableCount == 0 )
+		{
+			pxPin->xChangeTime = xNow;
+		}
+
+		pxPin->ucStableCount++;
+
+		if( pxPin->ucStableCount >= INPUT_DEBOUNCE_TICKS )
+		{
+			// Two states only: anything but the stable one is the other one
+			pxPin->xStableState = ( pxPin->xStableState == PIN_IS_HIGH ) ? PIN_IS_LOW : PIN_IS_HIGH;
+			pxPin->ucStableCount = 0;
+			prvInputPost( pxPin, pxPin->xChangeTime );
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+uint32_t ulInputServiceGetLostCount( void )
+{
+	return ulInputLostCount;
+}
@@ -0,0 +1,65 @@
+/*
+ * GPIO input event service.
+ *
+ * The LPC21xx can only interrupt on the few EINT pins, so every subscribed pin
+ * is sampled once per tick from the tick hook instead of by one polling task
+ * per button.  A new pin state has to hold for INPUT_DEBOUNCE_TICKS samples
+ * in a row before it is reported; the event carries the tick of its first
+ * sample and goes to the queue of every subscriber of the pin.  Tasks only
+ * wake up for real edges.
+ *
+ * Requires configUSE_TICK_HOOK set to 1, with vInputServiceScanFromISR()
+ * called from vApplicationTickHook().
+ */
+
+#ifndef INPUT_SERVICE_H
+#define INPUT_SERVICE_H
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "GPIO.h"
+
+// Number of pins and of subscribers per pin
+#ifndef INPUT_MAX_PINS
+#define INPUT_MAX_PINS 4
+#endif
+
+#ifndef INPUT_MAX_SUBSCRIBERS
+#define INPUT_MAX_SUBSCRIBERS 2
+#endif
+
+// Samples (ticks) a new state must hold to count as an edge
+#ifndef INPUT_DEBOUNCE_TICKS
+#define INPUT_DEBOUNCE_TICKS 5
+#endif
+
+// Type definitions
+typedef struct
+{
+	uint8_t ucInputId; // Chosen by the subscriber
+	pinState_t xState; // State after the edge
+	TickType_t xTimeStamp; // Tick at which the new state was first seen
+} InputEvent_st;
+
+/*
+ * Posts the edges of xPort/xPin to xSubscriber, a queue of InputEvent_st,
+ * tagged with ucInputId.  Returns pdFAIL when the pin or subscriber table is
+ * full.
+ */
+BaseType_t xInputServiceSubscribe( portX_t xPort,
+                                   pinX_t xPin,
+                                   uint8_t ucInputId,
+                                   QueueHandle_t xSubscriber );
+
+/*
+ * Samples every subscribed pin, call once per tick from the tick hook.
+ */
+void vInputServiceScanFromISR( void );
+
+/*
+ * Events lost because a subscriber queue was full.
+ */
+uint32_t ulInputServiceGetLostCount( void );
+
+#endif /* INPUT_SERVICE_H */
@@ -0,0 +1,66 @@
+/*
+ * Min-heap of items ordered by a tick count, see tick_heap.h.
+ */
+
+/* Scheduler includes. */
+#include "FreeRTOS.h"
+
+#include "tick_heap.h"
+
+/*-----------------------------------------------------------*/
+
+void vTickHeapSiftDown( TickHeap_st *pxHeap, UBaseType_t uxSlot )
+{
+	const TickType_t *pxKeys = pxHeap->pxKeys;
+	uint8_t *pucSlots = pxHeap->pucSlots;
+	UBaseType_t uxChild;
+	uint8_t ucItem = pucSlots[ uxSlot ];
+
+	for( ;; )
+	{
+		uxChild = ( 2 * uxSlot ) + 1;
+
+		if( uxChild >= pxHeap->uxCount )
+		{
+			break;
+		}
+
+		if( ( ( uxChild + 1 ) < pxHeap->uxCount ) &&
+			TICK_BEFORE( pxKeys[ pucSlots[ uxChild + 1 ] ], pxKeys[ pucSlots[ uxChild ] ] ) )
+		{
+			uxChild++;
+		}
+
+		if( !TICK_BEFORE( pxKeys[ pucSlots[ uxChild ] ], pxKeys[ ucItem ] ) )
+		{
+			break;
+		}
+
+		pucSlots[ uxSlot ] = pucSlots[ uxChild ];
+		uxSlot = uxChild;
+	}
+
+	pucSlots[ uxSlot ] = ucItem;
+}
+/*-----------------------------------------------------------*/
+
+void vTickHeapInit( TickHeap_st *pxHeap, uint8_t *pucSlots, const TickType_t *pxKeys, UBaseType_t uxCount )
+{
+	UBaseType_t uxIndex;
+
+	configASSERT( ( uxCount > 0 ) && ( uxCount <= 256 ) );
+
+	pxHeap->pucSlots = pucSlots;
+	pxHeap->pxKeys = pxKeys;
+	pxHeap->uxCount = uxCount;
+
+	for( uxIndex = 0; uxIndex < uxCount; uxIndex++ )
+	{
+		pucSlots[ uxIndex ] = ( uint8_t ) uxIndex;
+	}
+
+	for( uxIndex = uxCount / 2; uxIndex > 0; uxIndex-- )
+	{
+		vTickHeapSiftDown( pxHeap, uxIndex - 1 );
+	}
+}
@@ -0,0 +1,43 @@
+/*
+ * Min-heap of items ordered by a tick count.
+ *
+ * The heap holds item indices; the caller keeps the key of every item in a
+ * TickType_t array indexed by item and owns both arrays.  After moving the
+ * key of the root item later, vTickHeapSiftDown( pxHeap, 0 ) puts the heap
+ * back in order.  Keys are compared with TICK_BEFORE(), so the order holds
+ * across tick count overflow as long as all keys lie within half the tick
+ * range of each other.
+ */
+
+#ifndef TICK_HEAP_H
+#define TICK_HEAP_H
+
+#include "FreeRTOS.h"
+
+// xA is earlier than xB, safe across tick count overflow
+#define TICK_BEFORE(xA, xB) ( ( TickType_t ) ( ( xA ) - ( xB ) ) > ( portMAX_DELAY >> 1 ) )
+
+// Type definitions
+typedef struct
+{
+	uint8_t *pucSlots; // Item indices, earliest key at the root
+	const TickType_t *pxKeys; // Key of every item, indexed by item
+	UBaseType_t uxCount;
+} TickHeap_st;
+
+// Item with the earliest key, and that key
+#define ucTickHeapRoot( pxHeap ) ( ( pxHeap )->pucSlots[ 0 ] )
+#define xTickHeapRootKey( pxHeap ) ( ( pxHeap )->pxKeys[ ( pxHeap )->pucSlots[ 0 ] ] )
+
+/*
+ * Builds a heap of the items 0 to uxCount - 1, at most 256, keyed by
+ * pxKeys.  pucSlots has room for uxCount indices.  Set the keys first.
+ */
+void vTickHeapInit( TickHeap_st *pxHeap, uint8_t *pucSlots, const TickType_t *pxKeys, UBaseType_t uxCount );
+
+/*
+ * Moves the item in uxSlot down to its place.
+ */
+void vTickHeapSiftDown( TickHeap_st *pxHeap, UBaseType_t uxSlot );
+
+#endif /* TICK_HEAP_H */